@@ -0,0 +1,162 @@
+#include "Archetype.h"
+#include "ComponentManager.h"
+#include <new>
+
+/*
+\return The address of a component within a chunk.
+*/
+inline char* componentAddress(const Archetype& archetype, const Chunk& chunk, const unsigned int& column, const unsigned int& row)
+{
+	return chunk.data + archetype.offsets[column] + row * archetype.componentTypes[column].size;
+}
+
+Archetype* ArchetypeStorage::archetype(const Composition& composition)
+{
+	std::unordered_map<Composition, Archetype*>::iterator it = mArchetypeMap.find(composition);
+	if (it != mArchetypeMap.end())
+		return it->second;
+
+	Archetype* archetype = new Archetype;
+	archetype->composition = composition;
+	std::fill(archetype->columns, archetype->columns + MAX_COMPONENTS, -1);
+
+	unsigned int stride = sizeof(EntityID);
+	composition.forEach([archetype, &stride](const ComponentID& componentID)
+	{
+		const ComponentTypeInfo& typeInfo = ComponentManagerBase::componentManagerFromID(componentID).typeInfo;
+		assert(("[ERROR] Component alignment exceeds chunk alignment", typeInfo.alignment <= CHUNK_ALIGNMENT));
+
+		archetype->columns[componentID] = archetype->componentIDs.size();
+		archetype->componentIDs.push_back(componentID);
+		archetype->componentTypes.push_back(typeInfo);
+		stride += typeInfo.size;
+	});
+	archetype->offsets.resize(archetype->componentIDs.size());
+
+	// Find the largest number of entities whose components fit in a chunk once each array is aligned
+	archetype->capacity = CHUNK_SIZE / stride;
+	while (true)
+	{
+		unsigned int offset = archetype->capacity * sizeof(EntityID);
+		for (unsigned int i = 0; i < archetype->componentTypes.size(); i++)
+		{
+			unsigned int alignment = archetype->componentTypes[i].alignment;
+			offset = (offset + alignment - 1) / alignment * alignment;
+			archetype->offsets[i] = offset;
+			offset += archetype->capacity * archetype->componentTypes[i].size;
+		}
+		if (offset <= CHUNK_SIZE)
+			break;
+		archetype->capacity--;
+	}
+	assert(("[ERROR] Components of archetype do not fit in a chunk", archetype->capacity > 0));
+
+	mArchetypeMap.insert({ composition, archetype });
+	mArchetypes.push_back(archetype);
+	return archetype;
+}
+
+EntityLocation& ArchetypeStorage::location(const EntityID& entityID)
+{
+	unsigned int entityIndex = Entity::indexFromID(entityID);
+	if (entityIndex >= mLocations.size())
+		mLocations.resize(entityIndex + 1, { nullptr, 0, 0 });
+	return mLocations[entityIndex];
+}
+
+void ArchetypeStorage::move(const EntityID& entityID, Archetype* destination)
+{
+	EntityLocation& source = location(entityID);
+
+	// Allocate a row at the end of the destination archetype
+	EntityLocation target = { destination, 0, 0 };
+	if (destination)
+	{
+		if (destination->chunks.empty() || destination->chunks.back().size == destination->capacity)
+			destination->chunks.push_back({ (char*)::operator new(CHUNK_SIZE, std::align_val_t(CHUNK_ALIGNMENT)), 0 });
+
+		target.chunk = destination->chunks.size() - 1;
+		Chunk& chunk = destination->chunks.back();
+		target.row = chunk.size++;
+		destination->entities(chunk)[target.row] = entityID;
+	}
+
+	if (source.archetype)
+	{
+		Archetype& archetype = *source.archetype;
+		Chunk& chunk = archetype.chunks[source.chunk];
+
+		// Relocate components shared with the destination archetype and destroy the rest
+		for (unsigned int i = 0; i < archetype.componentIDs.size(); i++)
+		{
+			char* component = componentAddress(archetype, chunk, i, source.row);
+			if (destination && destination->columns[archetype.componentIDs[i]] != -1)
+				archetype.componentTypes[i].relocate(componentAddress(*destination, destination->chunks[target.chunk], destination->columns[archetype.componentIDs[i]], target.row), component);
+			else
+				archetype.componentTypes[i].destroy(component);
+		}
+
+		// Fill the gap left in the source archetype with its last entity. Ensures no gaps
+		Chunk& lastChunk = archetype.chunks.back();
+		unsigned int lastRow = lastChunk.size - 1;
+		if (&lastChunk != &chunk || lastRow != source.row)
+		{
+			EntityID lastID = archetype.entities(lastChunk)[lastRow];
+			for (unsigned int i = 0; i < archetype.componentIDs.size(); i++)
+				archetype.componentTypes[i].relocate(componentAddress(archetype, chunk, i, source.row), componentAddress(archetype, lastChunk, i, lastRow));
+
+			archetype.entities(chunk)[source.row] = lastID;
+			mLocations[Entity::indexFromID(lastID)].chunk = source.chunk;
+			mLocations[Entity::indexFromID(lastID)].row = source.row;
+		}
+
+		lastChunk.size--;
+		if (lastChunk.size == 0)
+		{
+			::operator delete(lastChunk.data, std::align_val_t(CHUNK_ALIGNMENT));
+			archetype.chunks.pop_back();
+		}
+	}
+
+	source = target;
+}
+
+ArchetypeStorage& ArchetypeStorage::instance()
+{
+	static ArchetypeStorage instance;
+	return instance;
+}
+
+ArchetypeStorage::~ArchetypeStorage()
+{
+	for (Archetype* archetype : mArchetypes)
+	{
+		for (Chunk& chunk : archetype->chunks)
+		{
+			for (unsigned int row = 0; row < chunk.size; row++)
+			{
+				for (unsigned int i = 0; i < archetype->componentIDs.size(); i++)
+					archetype->componentTypes[i].destroy(componentAddress(*archetype, chunk, i, row));
+			}
+			::operator delete(chunk.data, std::align_val_t(CHUNK_ALIGNMENT));
+		}
+		delete archetype;
+	}
+}
+
+void* ArchetypeStorage::addComponent(const EntityID& entityID, const ComponentID& componentID)
+{
+	const EntityLocation& entityLocation = location(entityID);
+	Composition composition = entityLocation.archetype ? entityLocation.archetype->composition : Composition();
+
+	move(entityID, archetype(composition | Composition::fromComponent(componentID)));
+	return getComponent(entityID, componentID);
+}
+
+void ArchetypeStorage::removeComponent(const EntityID& entityID, const ComponentID& componentID)
+{
+	const EntityLocation& entityLocation = location(entityID);
+	Composition composition = entityLocation.archetype->composition & ~Composition::fromComponent(componentID);
+
+	move(entityID, composition ? archetype(composition) : nullptr);
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include "Entity.h"
+
+#define CHUNK_SIZE 16384 // Size in bytes of each block of memory storing the entities and components of an archetype
+#define CHUNK_ALIGNMENT 64 // Alignment in bytes of each chunk
+
+// Move-constructs a component at destination from the component at source, then destroys the component at source.
+typedef void (*ComponentRelocateFunction)(void* destination, void* source);
+// Destroys the component at the address.
+typedef void (*ComponentDestroyFunction)(void* component);
+
+// Describes a component type to storage which only handles components as raw memory.
+struct ComponentTypeInfo
+{
+	unsigned int size;
+	unsigned int alignment;
+	ComponentRelocateFunction relocate;
+	ComponentDestroyFunction destroy;
+};
+
+// Fixed size block of memory containing an array of entity IDs followed by one array for each component type of its archetype.
+struct Chunk
+{
+	char* data;
+	unsigned int size; // Number of entities stored in the chunk
+};
+
+// Group of all entities sharing the same composition. Their components are stored together in chunks.
+struct Archetype
+{
+	Composition composition;
+
+	std::vector<ComponentID> componentIDs; // Component types stored by the archetype
+	std::vector<ComponentTypeInfo> componentTypes; // Parallel to componentIDs
+	std::vector<unsigned int> offsets; // Byte offset of each component array within a chunk, parallel to componentIDs
+	int columns[MAX_COMPONENTS]; // Maps component IDs to indices accessing componentIDs, -1 if the archetype does not store the component type
+
+	unsigned int capacity; // Number of entities each chunk can store
+
+	std::vector<Chunk> chunks;
+
+	EntityID* entities(const Chunk& chunk) const
+	{
+		return (EntityID*)chunk.data;
+	}
+
+	/*
+	\param chunk: Chunk of the archetype.
+	\param componentID: ID of a component type stored by the archetype.
+	\return The address of the chunk's array of components of the type.
+	*/
+	void* componentArray(const Chunk& chunk, const ComponentID& componentID) const
+	{
+		return chunk.data + offsets[columns[componentID]];
+	}
+};
+
+// Identifies where an entity's components are stored.
+struct EntityLocation
+{
+	Archetype* archetype; // nullptr if the entity has no components
+	unsigned int chunk;
+	unsigned int row;
+};
+
+/*
+Alternative storage engine for components, selected via ARCHETYPE_STORAGE. Entities with the same composition are grouped into archetypes whose components are
+stored in CHUNK_SIZE byte chunks with one array per component type, so iterating several component types streams through memory linearly.
+Entities move between archetypes whenever a component is added or removed; this invalidates references to all of the entity's components.
+*/
+class ArchetypeStorage
+{
+private:
+	std::unordered_map<Composition, Archetype*> mArchetypeMap;
+	std::vector<Archetype*> mArchetypes;
+
+	std::vector<EntityLocation> mLocations; // Indexed by entity slot index
+
+	ArchetypeStorage() {};
+
+	Archetype* archetype(const Composition& composition);
+
+	EntityLocation& location(const EntityID& entityID);
+
+	/*
+	Moves an entity's components to a new archetype. Components which are not stored by the new archetype are destroyed, 
+	while components of the new archetype which the entity did not previously possess are left uninitialized.
+	\param entityID: ID of the entity to move.
+	\param destination: Archetype to move the entity to, or nullptr to destroy all of its components.
+	*/
+	void move(const EntityID& entityID, Archetype* destination);
+
+public:
+	static ArchetypeStorage& instance();
+
+	ArchetypeStorage(const ArchetypeStorage& copy) = delete;
+	~ArchetypeStorage();
+
+	/*
+	Moves an entity to the archetype which additionally stores a component type.
+	\param entityID: ID of the entity.
+	\param componentID: ID of the component type being added.
+	\return The address of uninitialized memory in which the new component must be constructed.
+	*/
+	void* addComponent(const EntityID& entityID, const ComponentID& componentID);
+
+	/*
+	Destroys a component and moves the entity to the archetype which no longer stores the component type.
+	\param entityID: ID of the entity.
+	\param componentID: ID of the component type being removed.
+	*/
+	void removeComponent(const EntityID& entityID, const ComponentID& componentID);
+
+	/*
+	\param entityID: ID of the entity.
+	\param componentID: ID of a component type the entity possesses.
+	\return The address of the entity's component.
+	*/
+	void* getComponent(const EntityID& entityID, const ComponentID& componentID)
+	{
+		const EntityLocation& entityLocation = mLocations[Entity::indexFromID(entityID)];
+		const Archetype& entityArchetype = *entityLocation.archetype;
+		return entityArchetype.chunks[entityLocation.chunk].data + entityArchetype.offsets[entityArchetype.columns[componentID]] + entityLocation.row * entityArchetype.componentTypes[entityArchetype.columns[componentID]].size;
+	}
+
+	/*
+	\return All archetypes that have been created.
+	*/
+	const std::vector<Archetype*>& archetypes() const
+	{
+		return mArchetypes;
+	}
+};
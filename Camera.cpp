@@ -3,10 +3,6 @@
 CameraCreateInfo::operator Camera() const
 {
 	Camera camera;
-	camera.lastFov = 0.0f;
-	camera.lastAspect = 0.0f;
-	camera.lastZFar = 0.0f;
-	camera.lastZNear = 0.0f;
 	camera.fov = fov;
 	camera.aspect = aspect;
 	camera.zNear = zNear;
@@ -55,13 +51,6 @@ void deserialize(const std::vector<char>& vecData, Camera& write)
 
 CameraSystem::CameraSystem()
 {
-	mComposition = mTransformManager.bit | mCameraManager.bit; // Entities must possess both a Transform and Camera component in order to be added to the system
-
-	// Subscribe to component added and removed events so the entities can be added and removed from the system
-	mTransformManager.subscribeAddedEvent(&mComponentAddedCallback);
-	mTransformManager.subscribeRemovedEvent(&mComponentRemovedCallback);
-	mCameraManager.subscribeAddedEvent(&mComponentAddedCallback);
-	mCameraManager.subscribeRemovedEvent(&mComponentRemovedCallback);
 }
 
 CameraSystem& CameraSystem::instance()
@@ -70,82 +59,60 @@ CameraSystem& CameraSystem::instance()
 	return instance;
 }
 
-CameraSystem::~CameraSystem()
+void CameraSystem::componentAdded(const Entity& entity)
 {
-	mTransformManager.unsubscribeAddedEvent(&mComponentAddedCallback);
-	mTransformManager.unsubscribeRemovedEvent(&mComponentRemovedCallback);
-	mCameraManager.unsubscribeAddedEvent(&mComponentAddedCallback);
-	mCameraManager.unsubscribeRemovedEvent(&mComponentRemovedCallback);
+	Camera& camera = entity.getComponent<Camera>();
+
+	// Construct camera
+	camera.projectionChangedCallbacks.initialize();
+	camera.viewChangedCallbacks.initialize();
 }
 
-void CameraSystem::componentAdded(const Entity& entity)
+void CameraSystem::componentRemoved(const Entity& entity)
 {
-	if ((entity.composition() & mComposition) == mComposition) // Check if all required components have been added
-	{
-		Camera& camera = entity.getComponent<Camera>();
+	Camera& camera = entity.getComponent<Camera>();
 
-		// Construct camera
-		camera.projectionChangedCallbacks.initialize();
-		camera.viewChangedCallbacks.initialize();
-		entity.getComponent<Transform>().subscribeChangedEvent(&mTransformChangedCallback);
-
-		mEntityIDs.push_back(entity.ID()); // Add the entity to the system
-	}
+	// Free cameras callback arrays
+	camera.projectionChangedCallbacks.free();
+	camera.viewChangedCallbacks.free();
 }
 
-void CameraSystem::componentRemoved(const Entity& entity)
+void CameraSystem::updateViews() const
 {
-	std::vector<EntityID>::iterator IDIterator = std::find(mEntityIDs.begin(), mEntityIDs.end(), entity.ID());
-	if (IDIterator != mEntityIDs.end()) // Check if the entity is in the system
+	for (const TransformChange& change : mTransformSystem.changes())
 	{
-		Camera& camera = entity.getComponent<Camera>();
+		// The view matrix is dependent on position and rotation and so need not be updated if only the scale has changed
+		if (!(change.flags & (POSITION_CHANGED | ROTATION_CHANGED)) || !mEntityIDs.contains(change.entityID))
+			continue;
 
-		// Free cameras callback arrays
-		camera.projectionChangedCallbacks.free();
-		camera.viewChangedCallbacks.free();
+		const Transform& transform = mTransformManager.readComponent(change.entityID);
+		Camera& camera = mCameraManager.getComponent(change.entityID);
 
-		Transform& transform = entity.getComponent<Transform>();
-		if(transform.changedCallbacks.data) // Incase the transform's data has already been freed
-			transform.unsubscribeChangedEvent(&mTransformChangedCallback);
+		camera.viewMatrix = glm::lookAt(transform.worldPosition, transform.worldPosition + transform.worldDirection(), glm::vec3(0.0f, 1.0f, 0.0f));
 
-		mEntityIDs.erase(IDIterator); // Remove entity from the system
+		// Invoke view changed callbacks
+		for (unsigned int i = 0; i < camera.viewChangedCallbacks.length; i++)
+			(*camera.viewChangedCallbacks[i])(transform, camera);
 	}
 }
 
-void CameraSystem::transformChanged(Transform& transform) const
-{
-	Camera& camera = mCameraManager.getComponent(transform.entityID);
-	 
-	/* The view matrix is dependent on position and rotation and so must be updated once either of these change.
-       It is possible to check for the type of change (See Transform.h) however here if the transform has changed; it is assumed to always be a translation or rotation
-       since it does not make sense to enlarge a camera */
-	camera.viewMatrix = glm::lookAt(transform.worldPosition, transform.worldPosition + transform.worldDirection(), glm::vec3(0.0f, 1.0f, 0.0f));
-
-	// Invoke view changed callbacks
-	for (unsigned int i = 0; i < camera.viewChangedCallbacks.length; i++)
-		(*camera.viewChangedCallbacks[i])(transform, camera);
-}
-
-void CameraSystem::update() const
+void CameraSystem::update()
 {
-	// Detect change in projection parameters and update projection matrix accordingly
+	// Update the projection matrices of cameras accessed mutably since the last update, before the view update marks cameras as changed
 	for (const EntityID& ID : mEntityIDs)
 	{
+		if (!mCameraManager.changedSince(ID, mLastTick))
+			continue;
+
 		Camera& camera = mCameraManager.getComponent(ID);
+		camera.projectionMatrix = glm::perspective(glm::radians(camera.fov), camera.aspect, camera.zNear, camera.zFar); // Update projection matrix
 
-		// Check for change in projection parameters
-		if (camera.fov != camera.lastFov || camera.aspect != camera.lastAspect || camera.zNear != camera.lastZNear || camera.zFar != camera.lastZFar) 
-		{
-			camera.projectionMatrix = glm::perspective(glm::radians(camera.fov), camera.aspect, camera.zNear, camera.zFar); // Update projection matrix
+		// Invoke projection changed callbacks
+		for (unsigned int i = 0; i < camera.projectionChangedCallbacks.length; i++)
+			(*camera.projectionChangedCallbacks[i])(camera);
+	}
 
-			camera.lastFov = camera.fov;
-			camera.lastAspect = camera.aspect;
-			camera.lastZNear = camera.zNear;
-			camera.lastZFar = camera.zFar;
+	updateViews();
 
-			// Invoke projection changed callbacks
-			for (unsigned int i = 0; i < camera.projectionChangedCallbacks.length; i++)
-				(*camera.projectionChangedCallbacks[i])(camera);
-		}
-	}
+	mLastTick = ComponentManagerBase::advanceTick(); // Writes made during the update are ignored next time
 }
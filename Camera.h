@@ -1,5 +1,6 @@
 #pragma once
 #include "Transform.h"
+#include "EntitySet.h"
 
 struct Camera;
 
@@ -15,12 +16,7 @@ struct Camera
 	// Matrix which positions the scene for correct view
 	glm::mat4 viewMatrix;
 
-	// Store last frames state; enables camera system to detect changes and update matrices
-	float lastFov;
-	float lastAspect;
-	float lastZNear, lastZFar;
-
-	// Can be freely assigned to in order to adjust certain camera characteristics
+	// Can be freely assigned to in order to adjust certain camera characteristics. Camera system detects changes through the camera's change tick
 	float fov;
 	float aspect;
 	float zNear, zFar;
@@ -71,32 +67,29 @@ class CameraSystem
 private:
 	ComponentManager<Transform>& mTransformManager = ComponentManager<Transform>::instance();
 	ComponentManager<Camera>& mCameraManager = ComponentManager<Camera>::instance();
+	const TransformSystem& mTransformSystem = TransformSystem::instance();
 
-	const ComponentAddedCallback mComponentAddedCallback = std::bind(&CameraSystem::componentAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mComponentRemovedCallback = std::bind(&CameraSystem::componentRemoved, this, std::placeholders::_1);
-
-	const TransformChangedCallback mTransformChangedCallback = std::bind(&CameraSystem::transformChanged, this, std::placeholders::_1);
+	// Entities possessing both a Transform and Camera component
+	SystemEntitySet<Transform, Camera> mEntityIDs = { std::bind(&CameraSystem::componentAdded, this, std::placeholders::_1), std::bind(&CameraSystem::componentRemoved, this, std::placeholders::_1) };
 
-	Composition mComposition;
-	std::vector<EntityID> mEntityIDs;
+	ChangeTick mLastTick = 0; // Tick at which the last update ended. Only cameras changed since have their projection updated
 
 	CameraSystem();
 
+	// Updates the view matrices of cameras whose transforms changed during the last transform update.
+	void updateViews() const;
+
 public:
 	static CameraSystem& instance();
 
 	CameraSystem(const CameraSystem& copy) = delete;
-	~CameraSystem();
 
-	// Invoked after a component of interest to the CameraSystem is added to an entity. Should not be used outside of it's internal use.
+	// Invoked after an entity is added to the CameraSystem. Should not be used outside of it's internal use.
 	void componentAdded(const Entity& entity);
 
-	// Invoked before a component of interest to the CameraSystem is removed from an entity. Should not be used outside of it's internal use.
+	// Invoked before an entity is removed from the CameraSystem. Should not be used outside of it's internal use.
 	void componentRemoved(const Entity& entity);
 
-	// Invoked when a camera entity's transform has changed. Should not be used outside of it's internal use
-	void transformChanged(Transform& transform) const;
-
 	// Invoked every frame. Should not be used outside of it's internal use.
-	void update() const;
+	void update();
 };
\ No newline at end of file
@@ -3,13 +3,6 @@
 
 CameraControllerSystem::CameraControllerSystem()
 {
-	mTransformManager.subscribeAddedEvent(&mComponentAddedCallback);
-	mTransformManager.subscribeRemovedEvent(&mComponentRemovedCallback);
-	mCameraControllerManager.subscribeAddedEvent(&mComponentAddedCallback);
-	mCameraControllerManager.subscribeRemovedEvent(&mComponentRemovedCallback);
-	
-	mComposition = mTransformManager.bit | mCameraControllerManager.bit;
-
 	mLastCursorPosition = mWindowManager.cursorPosition();
 }
 
@@ -21,23 +14,6 @@ CameraControllerSystem& CameraControllerSystem::instance()
 
 CameraControllerSystem::~CameraControllerSystem()
 {
-	mTransformManager.unsubscribeAddedEvent(&mComponentAddedCallback);
-	mTransformManager.unsubscribeRemovedEvent(&mComponentRemovedCallback);
-	mCameraControllerManager.unsubscribeAddedEvent(&mComponentAddedCallback);
-	mCameraControllerManager.unsubscribeRemovedEvent(&mComponentRemovedCallback);
-}
-
-void CameraControllerSystem::componentAdded(const Entity& entity)
-{
-	if ((entity.composition() & mComposition) == mComposition)
-		mEntityIDs.push_back(entity.ID());
-}
-
-void CameraControllerSystem::componentRemoved(const Entity& entity)
-{
-	std::vector<EntityID>::iterator iterator = std::find(mEntityIDs.begin(), mEntityIDs.end(), entity.ID());
-	if (iterator != mEntityIDs.end())
-		mEntityIDs.erase(iterator);
 }
 
 void CameraControllerSystem::update(const double& deltaTime)
@@ -52,11 +28,8 @@ void CameraControllerSystem::update(const double& deltaTime)
 	mLastCursorPosition = cursorPosition;
 
 	// Input controls all CameraControllers in the scene.
-	for (const EntityID& ID : mEntityIDs)
+	mView.each([&](const EntityID& ID, Transform& transform, CameraController& cameraController)
 	{
-		Transform& transform = mTransformManager.getComponent(ID);
-		CameraController& cameraController = mCameraControllerManager.getComponent(ID);
-
 		if (cameraController.movement)
 		{
 			if (wDown)
@@ -74,5 +47,5 @@ void CameraControllerSystem::update(const double& deltaTime)
 			
 		if(cameraController.yaw)
 			transform.rotate(-cursorDelta.x * cameraController.mouseSensitivity, glm::vec3(0.0f, 1.0f, 0.0f));
-	}
+	});
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "WindowManager.h"
 #include "Transform.h"
+#include "View.h"
 #include "glm/glm.hpp"
 
 struct CameraController
@@ -12,18 +13,19 @@ struct CameraController
 	bool yaw;
 };
 
+template <>
+struct Reflection<CameraController>
+{
+	static constexpr FieldInfo fields[] = { REFLECT_FIELD(CameraController, movementSpeed), REFLECT_FIELD(CameraController, mouseSensitivity), REFLECT_FIELD(CameraController, movement),
+		REFLECT_FIELD(CameraController, pitch), REFLECT_FIELD(CameraController, yaw) };
+};
+
 class CameraControllerSystem
 {
 private:
-	ComponentManager<Transform>& mTransformManager = ComponentManager<Transform>::instance();
-	ComponentManager<CameraController>& mCameraControllerManager = ComponentManager<CameraController>::instance();
 	WindowManager& mWindowManager = WindowManager::instance();
 
-	const ComponentAddedCallback mComponentAddedCallback = std::bind(&CameraControllerSystem::componentAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mComponentRemovedCallback = std::bind(&CameraControllerSystem::componentRemoved, this, std::placeholders::_1);
-
-	Composition mComposition;
-	std::vector<EntityID> mEntityIDs;
+	View<Transform, CameraController> mView;
 
 	glm::vec2 mLastCursorPosition;
 
@@ -35,8 +37,5 @@ public:
 	CameraControllerSystem(const CameraControllerSystem& copy) = delete;
 	~CameraControllerSystem();
 
-	void componentAdded(const Entity& entity);
-	void componentRemoved(const Entity& entity);
-
 	void update(const double& deltaTime);
 };
\ No newline at end of file
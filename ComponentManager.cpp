@@ -1,21 +1,27 @@
 #include "ComponentManager.h"
 
-ComponentID ComponentManagerBase::queuedID = 0;
-std::unordered_map<ComponentID, ComponentManagerBase*> ComponentManagerBase::IDInstanceMap;
+ComponentManagerBase* ComponentManagerBase::managers[MAX_COMPONENTS] = {};
+ComponentOperations ComponentManagerBase::operations[MAX_COMPONENTS] = {};
+std::atomic<ChangeTick> ComponentManagerBase::currentTick(1); // Starts after 0 so systems which have never updated detect every component
 
-ComponentManagerBase::ComponentManagerBase(const char* componentName) :
-	componentName(componentName), ID(queuedID), bit(1ULL << queuedID)
+ComponentManagerBase::ComponentManagerBase(const ComponentID& ID, const char* componentName, const ComponentTypeInfo& typeInfo, const ComponentOperations& componentOperations) :
+	ID(ID), bit(Composition::fromComponent(ID)), componentName(componentName), typeInfo(typeInfo)
 {
-	IDInstanceMap.insert({ ID, this });
-	queuedID++;
+	managers[ID] = this;
+	operations[ID] = componentOperations;
 }
 
-ComponentManagerBase& ComponentManagerBase::componentManagerFromID(const ComponentID& ID)
+ChangeTick ComponentManagerBase::changeTick()
 {
-	return *IDInstanceMap.at(ID);
+	return currentTick.load(std::memory_order_relaxed);
+}
+
+ChangeTick ComponentManagerBase::advanceTick()
+{
+	return currentTick.fetch_add(1, std::memory_order_relaxed);
 }
 
 ComponentManagerBase::~ComponentManagerBase()
 {
-	IDInstanceMap.erase(ID);
+	managers[ID] = nullptr;
 }
@@ -1,63 +1,341 @@
 #pragma once
 #include "Entity.h"
+#include "ComponentTypes.h"
+#include "Archetype.h"
+#include "Reflection.h"
 #include <functional>
+#include <climits>
+#include <atomic>
+#include <new>
 
-typedef unsigned long long ComponentBit;
-typedef std::function<void(const Entity&)> ComponentAddedCallback;
-typedef std::function<void(const Entity&)> ComponentRemovedCallback;
+#define SPARSE_PAGE_SIZE 1024 // Number of entity slots covered by each page of a component manager's sparse array
+#define SPARSE_EMPTY UINT_MAX // Value of a sparse array element whose entity does not possess the component
 
-class ComponentManagerBase
+// Non-owning reference to a contiguous array of entity IDs.
+struct EntitySpan
 {
-private:
-	static ComponentID queuedID;
+	const EntityID* data;
+	unsigned int size;
 
-	static std::unordered_map<ComponentID, ComponentManagerBase*> IDInstanceMap;
+	const EntityID* begin() const
+	{
+		return data;
+	}
 
-protected:
-	ComponentManagerBase(const char* componentName);
+	const EntityID* end() const
+	{
+		return data + size;
+	}
+};
 
-public:
-	static ComponentManagerBase& componentManagerFromID(const ComponentID& ID);
-	
-	const ComponentID ID; // The unique ID identifying the managers component type
-	const ComponentBit bit; // The position of the bit in a Composition bitmask indicating possession of the component type
-	const char* componentName;
+typedef Composition ComponentBit;
+typedef unsigned int ChangeTick;
+typedef std::function<void(const Entity&)> ComponentAddedCallback;
+typedef std::function<void(const Entity&)> ComponentRemovedCallback;
+typedef std::function<void(const EntitySpan&)> ComponentsAddedCallback;
+typedef std::function<void(const EntitySpan&)> ComponentsRemovedCallback;
 
-	~ComponentManagerBase();
-	
+// Type erased operations of a component type, registered by its component manager.
+struct ComponentOperations
+{
 	/*
-	Removes component from an entity.
+	Removes a component from an entity.
 	\param Entity: Entity to remove the component from.
 	*/
-	virtual void removeComponent(const Entity& entity) = 0;
+	void (*removeComponent)(const Entity& entity);
+
+	/*
+	Removes components from several entities, notifying subscribers once for the whole batch before any component is removed.
+	\param entityIDs: Array of IDs of the entities to remove the component from.
+	\param count: Number of elements in entityIDs.
+	*/
+	void (*removeComponents)(const EntityID* entityIDs, const unsigned int& count);
+
+	/*
+	Adds copies of existing components to several entities. Subscribers are notified once all copies have been added.
+	\param sourceIDs: Array of IDs of the entities whose components to copy.
+	\param entityIDs: Array of IDs of the entities to add the copies to, parallel to sourceIDs.
+	\param count: Number of elements in sourceIDs and entityIDs.
+	*/
+	void (*addComponentCopies)(const EntityID* sourceIDs, const EntityID* entityIDs, const unsigned int& count);
 
 	/*
 	Retrieves component and serializes it.
 	\param ID: ID of the entity to get component from.
 	\return: The serialized component.
 	*/
-	virtual std::vector<char> getSerializedComponent(const EntityID& ID) = 0;
-	
+	std::vector<char> (*getSerializedComponent)(const EntityID& ID);
+
 	/*
 	Deserializes a serialized component and adds it to an entity.
 	\param vecData: The serialized component.
 	\param entity: Entity to add the component to.
 	*/
-	virtual void addSerializedComponent(const std::vector<char>& vecData, Entity& entity) = 0;
+	void (*addSerializedComponent)(const std::vector<char>& vecData, Entity& entity);
+
+	/*
+	Serializes the components of several entities into one block.
+	\param entityIDs: Array of IDs of the entities to get the components from.
+	\param count: Number of elements in entityIDs.
+	\param write: Array the serialized components are appended to.
+	*/
+	void (*serializeComponents)(const EntityID* entityIDs, const unsigned int& count, std::vector<char>& write);
+
+	/*
+	Deserializes a block written by serializeComponents and adds the components to several entities. Components of reflected types are added together and subscribers
+	are notified once all of them have been added. Components of other types are each added by addSerializedComponent, as their deserialize may depend on the entity
+	already owning the component.
+	\param read: Pointer to the block, advanced past it.
+	\param entityIDs: Array of IDs of the entities to add the components to.
+	\param count: Number of elements in entityIDs.
+	*/
+	void (*addSerializedComponents)(const char*& read, const EntityID* entityIDs, const unsigned int& count);
+};
+
+class ComponentManagerBase
+{
+private:
+	// Flat tables indexed by component ID, filled in as component managers are constructed
+	static ComponentManagerBase* managers[MAX_COMPONENTS];
+	static ComponentOperations operations[MAX_COMPONENTS];
+
+protected:
+	static std::atomic<ChangeTick> currentTick; // Tick stamped onto components as they are added or accessed mutably
+
+	ComponentManagerBase(const ComponentID& ID, const char* componentName, const ComponentTypeInfo& typeInfo, const ComponentOperations& componentOperations);
+
+public:
+	/*
+	\param ID: ID of a component type whose manager has been constructed.
+	\return The component type's manager.
+	*/
+	static ComponentManagerBase& componentManagerFromID(const ComponentID& ID)
+	{
+		assert(("[ERROR] Component manager of the component ID has not been constructed", managers[ID]));
+		return *managers[ID];
+	}
+
+	/*
+	Gets the operations of a component type from a flat table, so per component operations on entities involve no hash lookup or virtual call.
+	\param ID: ID of a component type whose manager has been constructed.
+	\return The component type's operations.
+	*/
+	static const ComponentOperations& operationsFromID(const ComponentID& ID)
+	{
+		assert(("[ERROR] Component manager of the component ID has not been constructed", managers[ID]));
+		return operations[ID];
+	}
+
+	/*
+	\return The tick which components added or accessed mutably from now on are stamped with.
+	*/
+	static ChangeTick changeTick();
+
+	/*
+	Ends the current tick so components written from now on are stamped with a later one. Systems detecting change should store the returned tick at the end of their
+	update and next time only process components changed since it, this way their own writes are ignored while writes made after the update are detected.
+	\return The tick which has ended.
+	*/
+	static ChangeTick advanceTick();
+	
+	const ComponentID ID; // The unique ID identifying the managers component type, its position within ComponentTypes
+	const ComponentBit bit; // Composition with only the bit indicating possession of the component type set
+	const char* componentName;
+	const ComponentTypeInfo typeInfo; // Size, alignment, and relocation procedures of the component type used by archetype storage
+
+	~ComponentManagerBase();
 };
 
 template <typename T>
 class ComponentManager : public ComponentManagerBase
 {
 private:
-	std::unordered_map<EntityID, unsigned int> mEntityIndexMap; // Maps entity IDs to indices accessing mComponents
+	/* Paged sparse array mapping entity slot indices to indices accessing mComponents. Pages are allocated once an entity slot within their range is given a component,
+	   elements of an allocated page hold SPARSE_EMPTY if their entity does not possess a component of type T. */
+	std::vector<unsigned int*> mSparsePages;
+	std::vector<EntityID> mEntities; // Dense array parallel to mComponents containing the ID of the entity which owns each component
+	std::vector<ChangeTick> mChangeTicks; // Dense array parallel to mEntities containing the tick each component was last added or accessed mutably during
+	#if ARCHETYPE_STORAGE
+	ArchetypeStorage& mArchetypeStorage = ArchetypeStorage::instance(); // Components are stored in archetype chunks rather than mComponents
+	#else
 	std::vector<T> mComponents; // Dynamic array containing all components of type T
+	#endif
 
 	// Dynamic arrays containing references to callbacks to be invoked when a component of type T is added or removed 
 	std::vector<ComponentAddedCallback*> mComponentAddedCallbacks;
 	std::vector<ComponentRemovedCallback*> mComponentRemovedCallbacks;
 
-	ComponentManager() : ComponentManagerBase(typeid(T).name()) {};
+	// Dynamic arrays containing references to callbacks to be invoked once per batch of components of type T added or removed
+	std::vector<ComponentsAddedCallback*> mComponentsAddedCallbacks;
+	std::vector<ComponentsRemovedCallback*> mComponentsRemovedCallbacks;
+
+	ComponentManager() : ComponentManagerBase(componentTypeID<T>, typeid(T).name(), { sizeof(T), alignof(T), &relocate, &destroy },
+		{ &removeComponentOperation, &removeComponentsOperation, &addComponentCopiesOperation, &getSerializedComponentOperation, &addSerializedComponentOperation,
+		  &serializeComponentsOperation, &addSerializedComponentsOperation }) {};
+
+	// Operations registered in the dispatch table of ComponentManagerBase
+	static void removeComponentOperation(const Entity& entity)
+	{
+		instance().removeComponent(entity);
+	}
+
+	static void removeComponentsOperation(const EntityID* entityIDs, const unsigned int& count)
+	{
+		instance().removeComponents(entityIDs, count);
+	}
+
+	static void addComponentCopiesOperation(const EntityID* sourceIDs, const EntityID* entityIDs, const unsigned int& count)
+	{
+		instance().addComponentCopies(sourceIDs, entityIDs, count);
+	}
+
+	static std::vector<char> getSerializedComponentOperation(const EntityID& ID)
+	{
+		return instance().getSerializedComponent(ID);
+	}
+
+	static void addSerializedComponentOperation(const std::vector<char>& vecData, Entity& entity)
+	{
+		instance().addSerializedComponent(vecData, entity);
+	}
+
+	static void serializeComponentsOperation(const EntityID* entityIDs, const unsigned int& count, std::vector<char>& write)
+	{
+		instance().serializeComponents(entityIDs, count, write);
+	}
+
+	static void addSerializedComponentsOperation(const char*& read, const EntityID* entityIDs, const unsigned int& count)
+	{
+		instance().addSerializedComponents(read, entityIDs, count);
+	}
+
+	static void relocate(void* destination, void* source)
+	{
+		new (destination) T(std::move(*(T*)source));
+		((T*)source)->~T();
+	}
+
+	static void destroy(void* component)
+	{
+		((T*)component)->~T();
+	}
+
+	/*
+	Gets the sparse array element of an entity, allocating its page if necessary.
+	\param entityID: ID of the entity.
+	\return A reference to the index of the entity's component in mComponents, or SPARSE_EMPTY.
+	*/
+	unsigned int& sparseIndex(const EntityID& entityID)
+	{
+		unsigned int entityIndex = Entity::indexFromID(entityID);
+		unsigned int page = entityIndex / SPARSE_PAGE_SIZE;
+		if (page >= mSparsePages.size())
+			mSparsePages.resize(page + 1, nullptr);
+
+		if (!mSparsePages[page])
+		{
+			mSparsePages[page] = new unsigned int[SPARSE_PAGE_SIZE];
+			std::fill(mSparsePages[page], mSparsePages[page] + SPARSE_PAGE_SIZE, SPARSE_EMPTY);
+		}
+		return mSparsePages[page][entityIndex % SPARSE_PAGE_SIZE];
+	}
+
+	/*
+	\param entityID: ID of the entity.
+	\return The index of the entity's component in mComponents, or SPARSE_EMPTY if the entity's slot does not possess a component of type T.
+	*/
+	unsigned int denseIndex(const EntityID& entityID) const
+	{
+		unsigned int entityIndex = Entity::indexFromID(entityID);
+		unsigned int page = entityIndex / SPARSE_PAGE_SIZE;
+		if (page >= mSparsePages.size() || !mSparsePages[page])
+			return SPARSE_EMPTY;
+		return mSparsePages[page][entityIndex % SPARSE_PAGE_SIZE];
+	}
+
+	/*
+	Stores a component for an entity without notifying subscribers.
+	\param entityID: ID of the entity to add the component to.
+	\param component: Component to add.
+	*/
+	void insertComponent(const EntityID& entityID, T&& component)
+	{
+		unsigned int& index = sparseIndex(entityID);
+		assert(("[ERROR] Cannot add component to entity that already possesses a component of that type", index == SPARSE_EMPTY));
+
+		index = mEntities.size(); // Entity ID now relates to the next free index
+		mEntities.push_back(entityID);
+		mChangeTicks.push_back(currentTick.load(std::memory_order_relaxed)); // An added component counts as changed
+		#if ARCHETYPE_STORAGE
+		new (mArchetypeStorage.addComponent(entityID, ID)) T(std::move(component)); // Move entity to its new archetype and construct component in the free slot
+		#else
+		mComponents.push_back(std::move(component)); // Add component at index
+		#endif
+
+		Entity::compositions[Entity::indexFromID(entityID)] |= bit; // Add component's bit to entity's composition
+	}
+
+	/*
+	Removes an entity's component without notifying subscribers.
+	\param entityID: ID of the entity to remove the component from.
+	*/
+	void eraseComponent(const EntityID& entityID)
+	{
+		assert(("[ERROR] Cannot remove component from an entity that does not possess a component of that type", hasComponent(entityID)));
+
+		Entity::compositions[Entity::indexFromID(entityID)] &= ~bit; // Remove component's bit from entity's composition
+
+		// Overwrite component being removed with the last component and redirect the last component's entity to its new index. Ensures no gaps
+		unsigned int& index = sparseIndex(entityID);
+		EntityID lastID = mEntities.back();
+		#if ARCHETYPE_STORAGE
+		mArchetypeStorage.removeComponent(entityID, ID); // Destroy component and move entity to its new archetype
+		#else
+		mComponents[index] = std::move(mComponents.back());
+		mComponents.pop_back(); // Free last component
+		#endif
+		mEntities[index] = lastID;
+		mChangeTicks[index] = mChangeTicks.back();
+		sparseIndex(lastID) = index;
+
+		mEntities.pop_back();
+		mChangeTicks.pop_back();
+		index = SPARSE_EMPTY; // Remove entity's ID mapping
+	}
+
+	// Notify subscribers of 'component added' event, per entity subscribers first so batched subscribers observe their changes
+	void notifyAdded(const EntitySpan& entityIDs)
+	{
+		if (!mComponentAddedCallbacks.empty())
+		{
+			for (const EntityID& entityID : entityIDs)
+			{
+				Entity entity(entityID);
+				for (ComponentAddedCallback* callback : mComponentAddedCallbacks)
+					(*callback)(entity);
+			}
+		}
+
+		for (ComponentsAddedCallback* callback : mComponentsAddedCallbacks)
+			(*callback)(entityIDs);
+	}
+
+	// Notify subscribers of 'component removed' event, per entity subscribers first so batched subscribers observe their changes
+	void notifyRemoved(const EntitySpan& entityIDs)
+	{
+		if (!mComponentRemovedCallbacks.empty())
+		{
+			for (const EntityID& entityID : entityIDs)
+			{
+				Entity entity(entityID);
+				for (ComponentRemovedCallback* callback : mComponentRemovedCallbacks)
+					(*callback)(entity);
+			}
+		}
+
+		for (ComponentsRemovedCallback* callback : mComponentsRemovedCallbacks)
+			(*callback)(entityIDs);
+	}
 
 public:
 	static ComponentManager& instance() 
@@ -68,6 +346,12 @@ public:
 
 	ComponentManager(const ComponentManager& copy) = delete;
 
+	~ComponentManager()
+	{
+		for (unsigned int* page : mSparsePages)
+			delete[] page;
+	}
+
 	/*
 	Adds a component of type T to the entity.
 	\param entity: Entity to add the component to.
@@ -76,79 +360,289 @@ public:
 	*/
 	T& addComponent(const Entity& entity, T component)
 	{
-		assert(("[ERROR] Cannot add component to entity that already possesses a component of that type", mEntityIndexMap.find(entity.ID()) == mEntityIndexMap.end()));
-
-		mEntityIndexMap.insert({ entity.mID, mComponents.size() }); // Entity ID now relates to the next free index
-		mComponents.push_back(component); // Add component at index
-
-		Entity::compositions[entity.mID] |= bit; // Add component's bit to entity's composition
-
-		// Notify subscribers of 'component added' event
-		for (ComponentAddedCallback* callback : mComponentAddedCallbacks)
-			(*callback)(entity);
+		insertComponent(entity.mID, std::move(component));
+		notifyAdded({ &entity.mID, 1 });
+		return getComponent(entity.mID);
+	}
 
-		return mComponents.back();
+	/*
+	Adds components of type T to several entities. Subscribers are notified once all components have been added.
+	\param entityIDs: Array of IDs of the entities to add the components to.
+	\param components: Array of components to add, parallel to entityIDs. Components are moved from the array.
+	\param count: Number of elements in entityIDs and components.
+	*/
+	void addComponents(const EntityID* entityIDs, T* components, const unsigned int& count)
+	{
+		for (unsigned int i = 0; i < count; i++)
+			insertComponent(entityIDs[i], std::move(components[i]));
+		notifyAdded({ entityIDs, count });
 	}
 
 	/*
-	Gets component of type T from the entity.
+	Gets component of type T from the entity for writing, marking it as changed during the current tick.
 	\param entityID: ID of entity to retrieve component from.
 	\return A reference to the component.
 	*/
 	T& getComponent(const EntityID& entityID)
 	{
-		#ifdef NDEBUG
-		return mComponents[mEntityIndexMap.at(entityID)];
+		unsigned int index = denseIndex(entityID);
+		assert(("[ERROR] Attempting to get component from an entity that does not possess a component of that type", index != SPARSE_EMPTY && mEntities[index] == entityID));
+		mChangeTicks[index] = currentTick.load(std::memory_order_relaxed);
+		#if ARCHETYPE_STORAGE
+		return *(T*)mArchetypeStorage.getComponent(entityID, ID);
 		#else
-		std::unordered_map<EntityID, unsigned int>::iterator IDIterator = mEntityIndexMap.find(entityID);
-		assert(("[ERROR] Attempting to get component from an entity that does not possess a component of that type", IDIterator != mEntityIndexMap.end()));
-		return mComponents[IDIterator->second];
+		return mComponents[index];
 		#endif
 	}
 
 	/*
-	Removes component of type T from the entity.
-	\param entity: Entity to remove the component from.
+	Gets component of type T from the entity for reading, without marking it as changed.
+	\param entityID: ID of entity to retrieve component from.
+	\return A reference to the component.
 	*/
-	void removeComponent(const Entity& entity) override
+	const T& readComponent(const EntityID& entityID) const
 	{
-		// Find entity in entity index map
-		std::unordered_map<EntityID, unsigned int>::iterator IDIterator = mEntityIndexMap.find(entity.ID());
-		assert(("[ERROR] Cannot remove component from an entity that does not possess a component of that type", IDIterator != mEntityIndexMap.end()));
+		unsigned int index = denseIndex(entityID);
+		assert(("[ERROR] Attempting to get component from an entity that does not possess a component of that type", index != SPARSE_EMPTY && mEntities[index] == entityID));
+		#if ARCHETYPE_STORAGE
+		return *(const T*)mArchetypeStorage.getComponent(entityID, ID);
+		#else
+		return mComponents[index];
+		#endif
+	}
 
-		// Notify subscribers of 'component removed' event
-		for (ComponentRemovedCallback* callback : mComponentRemovedCallbacks)
-			(*callback)(entity);
+	/*
+	Marks an entity's component as changed during the current tick, for components written without getComponent.
+	\param entityID: ID of the entity possessing the component.
+	*/
+	void markChanged(const EntityID& entityID)
+	{
+		unsigned int index = denseIndex(entityID);
+		assert(("[ERROR] Attempting to mark component of an entity that does not possess a component of that type", index != SPARSE_EMPTY && mEntities[index] == entityID));
+		mChangeTicks[index] = currentTick.load(std::memory_order_relaxed);
+	}
 
-		Entity::compositions[entity.mID] &= ~bit; // Remove component's bit from entity's composition
-		
-		// Find relation where it's index accesses the last element in 'mComponents', and assign the index to be the index of the component being removed
-		for (std::unordered_map<EntityID, unsigned int>::iterator it = mEntityIndexMap.begin(); it != mEntityIndexMap.end(); it++)
+	/*
+	Use to determine whether an entity's component has been added or accessed mutably since a tick.
+	\param entityID: ID of the entity possessing the component.
+	\param tick: Tick returned by ComponentManagerBase::advanceTick.
+	\return True if the component has changed after the tick ended, otherwise false.
+	*/
+	bool changedSince(const EntityID& entityID, const ChangeTick& tick) const
+	{
+		unsigned int index = denseIndex(entityID);
+		assert(("[ERROR] Attempting to query change of a component an entity does not possess", index != SPARSE_EMPTY && mEntities[index] == entityID));
+		return mChangeTicks[index] > tick;
+	}
+
+	/*
+	Collects every entity whose component has been added or accessed mutably since a tick. Only the dense array of ticks is scanned, not the components themselves.
+	\param tick: Tick returned by ComponentManagerBase::advanceTick.
+	\param entityIDs: Array the IDs of the changed components' entities are appended to, in the order the components are stored.
+	*/
+	void changedSince(const ChangeTick& tick, std::vector<EntityID>& entityIDs) const
+	{
+		for (unsigned int i = 0; i < mChangeTicks.size(); i++)
 		{
-			if (it->second == mComponents.size() - 1)
-			{
-				it->second = IDIterator->second;
-				break;
-			}
+			if (mChangeTicks[i] > tick)
+				entityIDs.push_back(mEntities[i]);
 		}
-		mComponents[IDIterator->second] = mComponents.back(); // Overwrite component being removed with last component. Ensures no gaps
+	}
 
-		mComponents.pop_back(); // Free last component
-		mEntityIndexMap.erase(IDIterator); // Remove entity's ID mapping
+	/*
+	\return The number of components of type T.
+	*/
+	unsigned int size() const
+	{
+		return mEntities.size();
+	}
+
+	/*
+	\return Array containing the ID of the entity which owns each component, in the order the components are stored.
+	*/
+	const std::vector<EntityID>& entities() const
+	{
+		return mEntities;
+	}
+
+	/*
+	Use to determine if an entity possesses a component of type T.
+	\param entityID: ID of the entity.
+	\return True if the entity possesses a component of type T, otherwise false. Always false if the ID refers to a destroyed entity.
+	*/
+	bool hasComponent(const EntityID& entityID) const
+	{
+		unsigned int index = denseIndex(entityID);
+		return index != SPARSE_EMPTY && mEntities[index] == entityID;
+	}
+
+	/*
+	Removes component of type T from the entity.
+	\param entity: Entity to remove the component from.
+	*/
+	void removeComponent(const Entity& entity)
+	{
+		assert(("[ERROR] Cannot remove component from an entity that does not possess a component of that type", hasComponent(entity.mID)));
+		notifyRemoved({ &entity.mID, 1 });
+		eraseComponent(entity.mID);
 	}
 
-	std::vector<char> getSerializedComponent(const EntityID& ID) override
+	/*
+	Removes components of type T from several entities, notifying subscribers once for the whole batch before any component is removed.
+	\param entityIDs: Array of IDs of the entities to remove the component from.
+	\param count: Number of elements in entityIDs.
+	*/
+	void removeComponents(const EntityID* entityIDs, const unsigned int& count)
 	{
-		T& component = getComponent(ID);
+		notifyRemoved({ entityIDs, count });
+		for (unsigned int i = 0; i < count; i++)
+			eraseComponent(entityIDs[i]);
+	}
+
+	/*
+	Adds copies of existing components of type T to several entities. Subscribers are notified once all copies have been added.
+	\param sourceIDs: Array of IDs of the entities whose components to copy.
+	\param entityIDs: Array of IDs of the entities to add the copies to, parallel to sourceIDs.
+	\param count: Number of elements in sourceIDs and entityIDs.
+	*/
+	void addComponentCopies(const EntityID* sourceIDs, const EntityID* entityIDs, const unsigned int& count)
+	{
+		// Grow the dense arrays once for the whole batch
+		mEntities.reserve(mEntities.size() + count);
+		mChangeTicks.reserve(mChangeTicks.size() + count);
+		#if !ARCHETYPE_STORAGE
+		mComponents.reserve(mComponents.size() + count);
+		#endif
+
+		for (unsigned int i = 0; i < count; i++)
+			insertComponent(entityIDs[i], T(readComponent(sourceIDs[i])));
+		notifyAdded({ entityIDs, count });
+	}
+
+	/*
+	Retrieves an entity's component and serializes it.
+	\param ID: ID of the entity to get component from.
+	\return: The serialized component.
+	*/
+	std::vector<char> getSerializedComponent(const EntityID& ID) const
+	{
+		const T& component = readComponent(ID);
 		return serialize(component);
 	}
 
-	void addSerializedComponent(const std::vector<char>& vecData, Entity& entity) override
+	/*
+	Deserializes a serialized component and adds it to an entity.
+	\param vecData: The serialized component.
+	\param entity: Entity to add the component to.
+	*/
+	void addSerializedComponent(const std::vector<char>& vecData, Entity& entity)
 	{
 		T& component = addComponent(entity, {});
 		deserialize(vecData, component);
 	}
 
+	/*
+	Serializes the components of several entities into one block. Components of reflected types are written as a packed array, with a single copy if the type is
+	trivially copyable and all of its fields are persistent, and field by field otherwise. Components of other types are each written by serialize<T> preceded by their size.
+	\param entityIDs: Array of IDs of the entities to get the components from.
+	\param count: Number of elements in entityIDs.
+	\param write: Array the serialized components are appended to.
+	*/
+	void serializeComponents(const EntityID* entityIDs, const unsigned int& count, std::vector<char>& write) const
+	{
+		if constexpr (reflected<T>)
+		{
+			unsigned int begin = write.size();
+			write.resize(begin + count * serializedSize<T>());
+			char* data = write.data() + begin;
+
+			if constexpr (bulkCopyable<T>())
+			{
+				#if !ARCHETYPE_STORAGE
+				if (entityIDs == mEntities.data() && count == mEntities.size())
+				{
+					memcpy(data, mComponents.data(), count * sizeof(T)); // Whole pool requested in storage order
+					return;
+				}
+				#endif
+				for (unsigned int i = 0; i < count; i++)
+					memcpy(data + i * sizeof(T), &readComponent(entityIDs[i]), sizeof(T));
+			}
+			else
+			{
+				for (unsigned int i = 0; i < count; i++)
+					writeFields(readComponent(entityIDs[i]), data);
+			}
+		}
+		else
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				std::vector<char> vecData = serialize(readComponent(entityIDs[i]));
+				unsigned int size = vecData.size();
+				write.insert(write.end(), reinterpret_cast<const char*>(&size), reinterpret_cast<const char*>(&size) + sizeof(unsigned int));
+				write.insert(write.end(), vecData.begin(), vecData.end());
+			}
+		}
+	}
+
+	/*
+	Deserializes a block written by serializeComponents and adds the components to several entities. Components of reflected types are added together and subscribers
+	are notified once all of them have been added. Components of other types are each added by addSerializedComponent, as their deserialize may depend on the entity
+	already owning the component.
+	\param read: Pointer to the block, advanced past it.
+	\param entityIDs: Array of IDs of the entities to add the components to.
+	\param count: Number of elements in entityIDs.
+	*/
+	void addSerializedComponents(const char*& read, const EntityID* entityIDs, const unsigned int& count)
+	{
+		if constexpr (reflected<T>)
+		{
+			std::vector<T> components(count);
+			if constexpr (bulkCopyable<T>())
+				memcpy(components.data(), read, count * sizeof(T));
+			else
+			{
+				const char* data = read;
+				for (T& component : components)
+					readFields(data, component);
+			}
+			read += count * serializedSize<T>();
+
+			mEntities.reserve(mEntities.size() + count);
+			mChangeTicks.reserve(mChangeTicks.size() + count);
+			#if !ARCHETYPE_STORAGE
+			mComponents.reserve(mComponents.size() + count);
+			#endif
+			addComponents(entityIDs, components.data(), count);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				unsigned int size;
+				memcpy(&size, read, sizeof(unsigned int));
+				read += sizeof(unsigned int);
+
+				Entity entity(entityIDs[i]);
+				addSerializedComponent(std::vector<char>(read, read + size), entity);
+				read += size;
+			}
+		}
+	}
+
+	/*
+	Serializes every component of type T, in storage order, together with the IDs of the entities owning them.
+	\param write: Array the component count, entity IDs, and block written by serializeComponents are appended to.
+	*/
+	void serializePool(std::vector<char>& write) const
+	{
+		unsigned int count = mEntities.size();
+		write.insert(write.end(), reinterpret_cast<const char*>(&count), reinterpret_cast<const char*>(&count) + sizeof(unsigned int));
+		write.insert(write.end(), reinterpret_cast<const char*>(mEntities.data()), reinterpret_cast<const char*>(mEntities.data() + count));
+		serializeComponents(mEntities.data(), count, write);
+	}
+
 	/*
 	Add a procedure to get automatically invoked whenever a component of type T is added to an entity.
 	\param callback: Pointer to the procedure to be added. Procedure must follow template: void [procedure name](const Entity& [entity name]).
@@ -184,4 +678,40 @@ public:
 	{
 		mComponentRemovedCallbacks.erase(std::find(mComponentRemovedCallbacks.begin(), mComponentRemovedCallbacks.end(), (ComponentRemovedCallback*)callback));
 	}
+
+	/*
+	Add a procedure to get automatically invoked once for each batch of components of type T added to entities. A single addComponent is a batch of one.
+	\param callback: Pointer to the procedure to be added. Procedure must follow template: void [procedure name](const EntitySpan& [entity IDs name]).
+	*/
+	void subscribeBatchAddedEvent(const ComponentsAddedCallback* callback)
+	{
+		mComponentsAddedCallbacks.push_back((ComponentsAddedCallback*)callback);
+	}
+
+	/*
+	Remove a procedure from the array of procedures that get invoked once a batch of components of type T is added.
+	\param callback: Pointer to the procedure to be removed.
+	*/
+	void unsubscribeBatchAddedEvent(const ComponentsAddedCallback* callback)
+	{
+		mComponentsAddedCallbacks.erase(std::find(mComponentsAddedCallbacks.begin(), mComponentsAddedCallbacks.end(), (ComponentsAddedCallback*)callback));
+	}
+
+	/*
+	Add a procedure to get automatically invoked once for each batch of components of type T removed from entities, before any of them are removed.
+	\param callback: Pointer to the procedure to be added. Procedure must follow template: void [procedure name](const EntitySpan& [entity IDs name]).
+	*/
+	void subscribeBatchRemovedEvent(const ComponentsRemovedCallback* callback)
+	{
+		mComponentsRemovedCallbacks.push_back((ComponentsRemovedCallback*)callback);
+	}
+
+	/*
+	Remove a procedure from the array of procedures that get invoked once a batch of components of type T is removed.
+	\param callback: Pointer to the procedure to be removed.
+	*/
+	void unsubscribeBatchRemovedEvent(const ComponentsRemovedCallback* callback)
+	{
+		mComponentsRemovedCallbacks.erase(std::find(mComponentsRemovedCallbacks.begin(), mComponentsRemovedCallbacks.end(), (ComponentsRemovedCallback*)callback));
+	}
 };
\ No newline at end of file
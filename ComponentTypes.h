@@ -0,0 +1,64 @@
+#pragma once
+#include "Entity.h"
+#include <type_traits>
+
+struct Transform;
+struct Transform2D;
+struct Camera;
+struct Mesh;
+struct DirectionalLight;
+struct Sprite;
+struct UIText;
+struct UIButton;
+struct CameraController;
+struct RigidBody;
+struct CharacterController;
+struct Interactor;
+struct Interactable;
+struct Snake;
+struct EntityButtonInfo;
+
+template <typename... Ts>
+struct TypeList {};
+
+/*
+Every component type, in order of ID. A type's position within the list is its component ID, so IDs are known at compile time and identical across builds and runs
+regardless of the order component managers are constructed in, keeping serialized entities valid. New component types must be appended to the end of the list,
+and types which are no longer used should be left in place.
+*/
+typedef TypeList<Transform, Transform2D, Camera, Mesh, DirectionalLight, Sprite, UIText, UIButton, CameraController, RigidBody, CharacterController, Interactor, Interactable, Snake,
+	Inactive, EntityButtonInfo> ComponentTypes;
+
+template <typename T>
+constexpr bool unregisteredComponentType = false;
+
+// Position of T within a type list.
+template <typename T, typename List>
+struct TypeIndex
+{
+	static_assert(unregisteredComponentType<T>, "[ERROR] Component type must be added to ComponentTypes");
+};
+
+template <typename T, typename... Ts>
+struct TypeIndex<T, TypeList<T, Ts...>>
+{
+	static constexpr ComponentID value = 0;
+};
+
+template <typename T, typename U, typename... Ts>
+struct TypeIndex<T, TypeList<U, Ts...>>
+{
+	static constexpr ComponentID value = 1 + TypeIndex<T, TypeList<Ts...>>::value;
+};
+
+// ID of component type T.
+template <typename T>
+constexpr ComponentID componentTypeID = TypeIndex<typename std::remove_const<T>::type, ComponentTypes>::value;
+
+template <typename... Ts>
+constexpr unsigned int typeListSize(TypeList<Ts...>)
+{
+	return sizeof...(Ts);
+}
+
+static_assert(typeListSize(ComponentTypes()) <= MAX_COMPONENTS, "[ERROR] Number of component types exceeds MAX_COMPONENTS");
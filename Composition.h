@@ -0,0 +1,224 @@
+#pragma once
+#include "Vulkan.h"
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COMPOSITION_SSE2 true
+#include <emmintrin.h>
+#else
+#define COMPOSITION_SSE2 false
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define COMPOSITION_WORDS (MAX_COMPONENTS / 64) // Number of 64 bit words making up a composition
+
+static_assert(MAX_COMPONENTS > 0 && MAX_COMPONENTS % 128 == 0, "[ERROR] MAX_COMPONENTS must be a multiple of 128");
+
+/*
+\param word: A non-zero 64 bit word.
+\return The index of the lowest set bit of the word.
+*/
+inline unsigned int countTrailingZeros(const unsigned long long& word)
+{
+	#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return index;
+	#else
+	return __builtin_ctzll(word);
+	#endif
+}
+
+/*
+\param word: A 64 bit word.
+\return The number of set bits in the word.
+*/
+inline unsigned int populationCount(const unsigned long long& word)
+{
+	#ifdef _MSC_VER
+	return (unsigned int)__popcnt64(word);
+	#else
+	return __builtin_popcountll(word);
+	#endif
+}
+
+/*
+Fixed width bitmask with one bit per component type, MAX_COMPONENTS bits wide. A set bit indicates possession of the component type whose ID is the bit's position.
+*/
+class alignas(16) Composition
+{
+private:
+	unsigned long long mWords[COMPOSITION_WORDS];
+
+public:
+	Composition() : mWords() {}
+
+	/*
+	\param componentID: ID of a component type.
+	\return A composition with only the component type's bit set.
+	*/
+	static Composition fromComponent(const unsigned int& componentID)
+	{
+		assert(("[ERROR] Component ID exceeds MAX_COMPONENTS", componentID < MAX_COMPONENTS));
+		Composition result;
+		result.mWords[componentID / 64] = 1ULL << (componentID % 64);
+		return result;
+	}
+
+	/*
+	\param componentID: ID of a component type.
+	\return True if the component type's bit is set, otherwise false.
+	*/
+	bool test(const unsigned int& componentID) const
+	{
+		return (mWords[componentID / 64] >> (componentID % 64)) & 1;
+	}
+
+	/*
+	Use to determine whether this composition possesses every component type of another. Used to test whether entities meet a system's criteria.
+	\param subset: The required composition.
+	\return True if every bit set in subset is also set in this composition, otherwise false.
+	*/
+	bool contains(const Composition& subset) const
+	{
+		#if COMPOSITION_SSE2
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i += 2)
+		{
+			__m128i words = _mm_load_si128((const __m128i*)(mWords + i));
+			__m128i subsetWords = _mm_load_si128((const __m128i*)(subset.mWords + i));
+			// Bits set in subset but not this composition
+			__m128i missing = _mm_andnot_si128(words, subsetWords);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) != 0xFFFF)
+				return false;
+		}
+		return true;
+		#else
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+		{
+			if (subset.mWords[i] & ~mWords[i])
+				return false;
+		}
+		return true;
+		#endif
+	}
+
+	/*
+	\return True if any bit is set, otherwise false.
+	*/
+	bool any() const
+	{
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+		{
+			if (mWords[i])
+				return true;
+		}
+		return false;
+	}
+
+	explicit operator bool() const
+	{
+		return any();
+	}
+
+	/*
+	\return The number of set bits.
+	*/
+	unsigned int count() const
+	{
+		unsigned int result = 0;
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+			result += populationCount(mWords[i]);
+		return result;
+	}
+
+	/*
+	Invokes a procedure for each set bit in ascending order, skipping directly between set bits.
+	\param function: Procedure to invoke. Must follow template: void [procedure name](const ComponentID& [component ID name]).
+	*/
+	template <typename Function>
+	void forEach(Function function) const
+	{
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+		{
+			unsigned long long word = mWords[i];
+			while (word)
+			{
+				function(i * 64 + countTrailingZeros(word));
+				word &= word - 1; // Clear lowest set bit
+			}
+		}
+	}
+
+	Composition operator &(const Composition& other) const
+	{
+		Composition result;
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+			result.mWords[i] = mWords[i] & other.mWords[i];
+		return result;
+	}
+
+	Composition operator |(const Composition& other) const
+	{
+		Composition result;
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+			result.mWords[i] = mWords[i] | other.mWords[i];
+		return result;
+	}
+
+	Composition operator ~() const
+	{
+		Composition result;
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+			result.mWords[i] = ~mWords[i];
+		return result;
+	}
+
+	Composition& operator &=(const Composition& other)
+	{
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+			mWords[i] &= other.mWords[i];
+		return *this;
+	}
+
+	Composition& operator |=(const Composition& other)
+	{
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+			mWords[i] |= other.mWords[i];
+		return *this;
+	}
+
+	bool operator ==(const Composition& other) const
+	{
+		for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+		{
+			if (mWords[i] != other.mWords[i])
+				return false;
+		}
+		return true;
+	}
+
+	bool operator !=(const Composition& other) const
+	{
+		return !(*this == other);
+	}
+
+	friend struct std::hash<Composition>;
+};
+
+namespace std
+{
+	template <>
+	struct hash<Composition>
+	{
+		size_t operator()(const Composition& composition) const
+		{
+			size_t result = 0;
+			for (unsigned int i = 0; i < COMPOSITION_WORDS; i++)
+				result ^= hash<unsigned long long>()(composition.mWords[i]) + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2);
+			return result;
+		}
+	};
+}
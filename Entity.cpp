@@ -1,40 +1,134 @@
 #include "ComponentManager.h"
 #include "Transform.h"
+#include <algorithm>
+
+// Slot 0 is reserved for the null ID
+std::vector<unsigned int> Entity::freeIndices;
+std::vector<unsigned char> Entity::generations = { 0 };
+std::vector<Composition> Entity::compositions = { Composition() };
+#if ENTITY_NAMES
+std::vector<NameHandle> Entity::names = { 0 };
+std::vector<unsigned int> Entity::namePositions = { 0 };
+std::vector<std::vector<EntityID>> Entity::namedEntities = { {} };
+#endif
+
+void Entity::assignName(const EntityID& ID, const NameHandle& name)
+{
+	#if ENTITY_NAMES
+	unsigned int index = indexFromID(ID);
+	if (names[index])
+	{
+		// Move the last entity with the previous name into the entity's position
+		std::vector<EntityID>& previousEntities = namedEntities[names[index]];
+		EntityID lastID = previousEntities.back();
+		previousEntities[namePositions[index]] = lastID;
+		namePositions[indexFromID(lastID)] = namePositions[index];
+		previousEntities.pop_back();
+	}
 
-std::vector<EntityID> Entity::freeIDStack = { 1 };
-std::unordered_map<EntityID, Composition> Entity::compositions;
-std::unordered_map<EntityID, std::string> Entity::names;
+	names[index] = name;
+	if (name)
+	{
+		if (name >= namedEntities.size())
+			namedEntities.resize(name + 1);
+		namePositions[index] = namedEntities[name].size();
+		namedEntities[name].push_back(ID);
+	}
+	#endif
+}
 
-Composition& Entity::getCompositionFromID(const EntityID& ID)
+std::string Entity::getNameFromID(const EntityID& ID)
 {
-	return compositions.at(ID);
+	assert(("[ERROR] Could not dereference ID", valid(ID)));
+	#if ENTITY_NAMES
+	if (names[indexFromID(ID)])
+		return NamePool::instance().string(names[indexFromID(ID)]);
+	#endif
+	return "Entity " + std::to_string(indexFromID(ID));
 }
 
-std::string& Entity::getNameFromID(const EntityID& ID)
+NameHandle Entity::getNameHandleFromID(const EntityID& ID)
 {
-	return names.at(ID);
+	assert(("[ERROR] Could not dereference ID", valid(ID)));
+	#if ENTITY_NAMES
+	return names[indexFromID(ID)];
+	#else
+	return 0;
+	#endif
 }
 
-Entity::Entity(const std::string& name) :
-	mID(freeIDStack.back())
+const std::vector<EntityID>& Entity::findByName(const std::string_view& name)
 {
-	freeIDStack.pop_back(); // Remove ID from queue
+	static const std::vector<EntityID> none;
+	#if ENTITY_NAMES
+	NameHandle handle = NamePool::instance().find(name);
+	if (handle && handle < namedEntities.size())
+		return namedEntities[handle];
+	#endif
+	return none;
+}
+
+void Entity::createEntities(EntityID* entityIDs, const unsigned int& count, const NameHandle& name)
+{
+	// Reuse free slots first, then append the remaining slots in one allocation
+	unsigned int nReused = std::min(count, (unsigned int)freeIndices.size());
+	unsigned int firstIndex = compositions.size();
+	unsigned int nSlots = firstIndex + count - nReused;
+	assert(("[ERROR] Exceeded maximum number of entities", nSlots - 1 <= ENTITY_INDEX_MASK));
+	generations.resize(nSlots, 0);
+	compositions.resize(nSlots);
+	#if ENTITY_NAMES
+	names.resize(nSlots, 0);
+	namePositions.resize(nSlots);
+	#endif
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		unsigned int index;
+		if (i < nReused)
+		{
+			index = freeIndices.back();
+			freeIndices.pop_back();
+		}
+		else
+			index = firstIndex + i - nReused;
+
+		entityIDs[i] = ((EntityID)generations[index] << ENTITY_INDEX_BITS) | index;
+		assignName(entityIDs[i], name);
+	}
+}
 
-	if (freeIDStack.empty()) // If queue is empty, it is guranteed that all IDs to 'mID' are used
-		freeIDStack.push_back(mID + 1); // So next ID assigned should be 'mID' + 1
+Entity::Entity(const std::string& name)
+{
+	unsigned int index;
+	if (freeIndices.empty()) // No slots to reuse so append a new slot
+	{
+		index = compositions.size();
+		assert(("[ERROR] Exceeded maximum number of entities", index <= ENTITY_INDEX_MASK));
+		generations.push_back(0);
+		compositions.emplace_back();
+		#if ENTITY_NAMES
+		names.push_back(0);
+		namePositions.emplace_back();
+		#endif
+	}
+	else
+	{
+		index = freeIndices.back();
+		freeIndices.pop_back(); // Remove index from queue
+	}
 
-	compositions.insert({ mID, 0 });
-	names.insert({ mID, name == "" ? "Entity " + std::to_string(mID) : name });
+	mID = ((EntityID)generations[index] << ENTITY_INDEX_BITS) | index;
+	#if ENTITY_NAMES
+	if (!name.empty())
+		assignName(mID, NamePool::instance().intern(name));
+	#endif
 }
 
 Entity::Entity(const EntityID& ID) :
 	mID(ID)
 {
-	assert(("[ERROR] Could not dereference ID", ID && ID < freeIDStack.front()));
-	#ifndef NDEBUG
-	for (unsigned int i = 1; i < freeIDStack.size(); i++)
-		assert(("[ERROR] Could not dereference ID", ID != freeIDStack[i]));
-	#endif
+	assert(("[ERROR] Could not dereference ID", valid(ID)));
 }
 
 Entity::Entity(const Entity& copy) : mID(copy.mID) {}
@@ -47,20 +141,19 @@ Entity& Entity::operator=(const Entity& other)
 void Entity::destroy()
 {
 	// Remove all components from entity
-	Composition composition = compositions[mID];
-	for (ComponentID componentID = 0; componentID < 64; componentID++)
+	unsigned int index = indexFromID(mID);
+	Composition composition = compositions[index];
+	composition.forEach([this](const ComponentID& componentID)
 	{
-		if ((composition >> componentID) & 1)
-		{
-			ComponentManagerBase::componentManagerFromID(componentID).removeComponent(*this);
-		}
-	}
+		ComponentManagerBase::operationsFromID(componentID).removeComponent(*this);
+	});
 
-	// Remove entity's entries in maps
-	compositions.erase(mID); 
-	names.erase(mID);
+	// Reset entity's slot and invalidate all IDs referring to it. The 8 bit generation wraps around after 256 reuses of a slot
+	compositions[index] = Composition();
+	assignName(mID, 0);
+	generations[index]++;
 
-	freeIDStack.push_back(mID); // Add ID to queue to be reused
+	freeIndices.push_back(index); // Add index to queue to be reused
 	mID = 0;
 }
 
@@ -74,31 +167,77 @@ const EntityID Entity::ID() const
 	return mID;
 }
 
-const Composition& Entity::composition() const
+void Entity::setName(const std::string& name)
 {
-	return compositions[mID];
+	#if ENTITY_NAMES
+	assignName(mID, NamePool::instance().intern(name));
+	#endif
 }
 
-void Entity::setName(const std::string& name)
+std::string Entity::name() const
 {
-	names[mID] = name;
+	return getNameFromID(mID);
 }
 
-const std::string& Entity::name() const
+unsigned int Entity::nbComponents() const
 {
-	return names[mID];
+	return compositions[indexFromID(mID)].count();
 }
 
-unsigned int Entity::nbComponents() const
+/*
+Appends the IDs of an entity and every entity in its transform hierarchy to an array.
+\param entityID: ID of the hierarchy's root.
+\param entityIDs: Array to append to.
+*/
+static void hierarchyIDs(const EntityID& entityID, std::vector<EntityID>& entityIDs)
 {
-	unsigned int nComponents = 0;
-	Composition composition = compositions[mID];
-	for (ComponentID componentID = 0; componentID < 64; componentID++)
+	static ComponentManager<Transform>& transformManager = ComponentManager<Transform>::instance();
+	static ComponentManager<Transform2D>& transform2DManager = ComponentManager<Transform2D>::instance();
+
+	entityIDs.push_back(entityID);
+
+	if (transformManager.hasComponent(entityID))
 	{
-		if ((composition >> componentID) & 1)
-			nComponents++;
+		for (const EntityID& childID : transformManager.readComponent(entityID).children())
+			hierarchyIDs(childID, entityIDs);
+	}
+	else if (transform2DManager.hasComponent(entityID))
+	{
+		for (const EntityID& childID : transform2DManager.readComponent(entityID).children())
+			hierarchyIDs(childID, entityIDs);
 	}
-	return nComponents;
+}
+
+void Entity::deactivate() const
+{
+	static ComponentManager<Inactive>& inactiveManager = ComponentManager<Inactive>::instance();
+
+	std::vector<EntityID> entityIDs;
+	hierarchyIDs(mID, entityIDs);
+	entityIDs.erase(std::remove_if(entityIDs.begin(), entityIDs.end(), [](const EntityID& entityID) { return inactiveManager.hasComponent(entityID); }), entityIDs.end());
+
+	// Tag the whole hierarchy in one batch
+	std::vector<Inactive> components(entityIDs.size());
+	if (!entityIDs.empty())
+		inactiveManager.addComponents(entityIDs.data(), components.data(), entityIDs.size());
+}
+
+void Entity::activate() const
+{
+	static ComponentManager<Inactive>& inactiveManager = ComponentManager<Inactive>::instance();
+
+	std::vector<EntityID> entityIDs;
+	hierarchyIDs(mID, entityIDs);
+	entityIDs.erase(std::remove_if(entityIDs.begin(), entityIDs.end(), [](const EntityID& entityID) { return !inactiveManager.hasComponent(entityID); }), entityIDs.end());
+
+	if (!entityIDs.empty())
+		inactiveManager.removeComponents(entityIDs.data(), entityIDs.size());
+}
+
+bool Entity::active() const
+{
+	static ComponentManager<Inactive>& inactiveManager = ComponentManager<Inactive>::instance();
+	return !compositions[indexFromID(mID)].test(inactiveManager.ID);
 }
 
 template<>
@@ -111,28 +250,25 @@ std::vector<char> serialize(const Entity& entity)
 
 	Composition entityComposition = entity.composition();
 
-	for (ComponentID componentID = 0; componentID < 64; componentID++)
+	entityComposition.forEach([&](const ComponentID& componentID)
 	{
-		if ((entityComposition >> componentID) & 1)
-		{
-			vecData = serialize(componentID);
-			result.insert(result.end(), vecData.begin(), vecData.end());
-			vecData = ComponentManagerBase::componentManagerFromID(componentID).getSerializedComponent(entity.ID());
-			std::vector<char> tempVecData = serialize((unsigned int)vecData.size());
-			result.insert(result.end(), tempVecData.begin(), tempVecData.end());
-			result.insert(result.end(), vecData.begin(), vecData.end());
-		}
-	}
+		vecData = serialize(componentID);
+		result.insert(result.end(), vecData.begin(), vecData.end());
+		vecData = ComponentManagerBase::operationsFromID(componentID).getSerializedComponent(entity.ID());
+		std::vector<char> tempVecData = serialize((unsigned int)vecData.size());
+		result.insert(result.end(), tempVecData.begin(), tempVecData.end());
+		result.insert(result.end(), vecData.begin(), vecData.end());
+	});
 
 	if (entity.hasComponent<Transform>())
 	{
 		Transform& transform = entity.getComponent<Transform>();
-		vecData = serialize(transform.childrenIDs.length);
+		vecData = serialize(transform.nChildren);
 		result.insert(result.end(), vecData.begin(), vecData.end());
 
-		for (unsigned int i = 0; i < transform.childrenIDs.length; i++)
+		for (const EntityID& childID : transform.children())
 		{
-			vecData = serialize(Entity(transform.childrenIDs[i]));
+			vecData = serialize(Entity(childID));
 			std::vector<char> tempVecData = serialize((unsigned int)vecData.size());
 			result.insert(result.end(), tempVecData.begin(), tempVecData.end());
 			result.insert(result.end(), vecData.begin(), vecData.end());
@@ -170,7 +306,7 @@ void deserialize(const std::vector<char>& vecData, Entity& entity)
 		begin += size;
 
 		size = componentSize;
-		ComponentManagerBase::componentManagerFromID(componentID).addSerializedComponent(std::vector<char>(vecData.data() + begin, vecData.data() + begin + size), entity);
+		ComponentManagerBase::operationsFromID(componentID).addSerializedComponent(std::vector<char>(vecData.data() + begin, vecData.data() + begin + size), entity);
 		begin += size;
 	}
 
@@ -203,9 +339,9 @@ void destroyChildren(const Entity& entity)
 	if (entity.hasComponent<Transform>())
 	{
 		Transform& transform = entity.getComponent<Transform>();
-		while (transform.childrenIDs.length != 0)
+		while (transform.firstChildID)
 		{
-			Entity child(transform.childrenIDs[0]);
+			Entity child(transform.firstChildID);
 			destroyChildren(child);
 			child.destroy();
 
@@ -215,9 +351,9 @@ void destroyChildren(const Entity& entity)
 	else if (entity.hasComponent<Transform2D>())
 	{
 		Transform2D& transform = entity.getComponent<Transform2D>();
-		while (transform.childrenIDs.length != 0)
+		while (transform.firstChildID)
 		{
-			Entity child(transform.childrenIDs[0]);
+			Entity child(transform.firstChildID);
 			destroyChildren(child);
 			child.destroy();
 
@@ -225,3 +361,75 @@ void destroyChildren(const Entity& entity)
 		}
 	}
 }
+
+
+std::vector<EntityID> instantiate(const Entity& prefab, const unsigned int& count)
+{
+	static ComponentManager<Transform>& transformManager = ComponentManager<Transform>::instance();
+	static ComponentManager<Transform2D>& transform2DManager = ComponentManager<Transform2D>::instance();
+
+	// Flatten the prefab's hierarchy breadth first, so every node's parent precedes it
+	bool hierarchy2D = !prefab.hasComponent<Transform>() && prefab.hasComponent<Transform2D>();
+	std::vector<EntityID> nodeIDs = { prefab.ID() };
+	std::vector<unsigned int> parentNodes = { 0 };
+	for (unsigned int node = 0; node < nodeIDs.size(); node++)
+	{
+		EntityID childID;
+		if (hierarchy2D)
+			childID = transform2DManager.readComponent(nodeIDs[node]).firstChildID;
+		else if (transformManager.hasComponent(nodeIDs[node]))
+			childID = transformManager.readComponent(nodeIDs[node]).firstChildID;
+		else
+			continue;
+
+		while (childID)
+		{
+			nodeIDs.push_back(childID);
+			parentNodes.push_back(node);
+			childID = hierarchy2D ? transform2DManager.readComponent(childID).nextSiblingID : transformManager.readComponent(childID).nextSiblingID;
+		}
+	}
+
+	// Copies of each node are contiguous so each node's copies form one span
+	std::vector<EntityID> entityIDs(nodeIDs.size() * count);
+	Composition composition;
+	for (unsigned int node = 0; node < nodeIDs.size(); node++)
+	{
+		Entity::createEntities(entityIDs.data() + node * count, count, Entity::getNameHandleFromID(nodeIDs[node]));
+		composition |= Entity::getCompositionFromID(nodeIDs[node]);
+	}
+
+	// Copy one component type at a time so subscribers are notified once per type
+	std::vector<EntityID> sourceIDs;
+	std::vector<EntityID> copyIDs;
+	composition.forEach([&](const ComponentID& componentID)
+	{
+		sourceIDs.clear();
+		copyIDs.clear();
+		for (unsigned int node = 0; node < nodeIDs.size(); node++)
+		{
+			if (Entity::getCompositionFromID(nodeIDs[node]).test(componentID))
+			{
+				sourceIDs.insert(sourceIDs.end(), count, nodeIDs[node]);
+				copyIDs.insert(copyIDs.end(), entityIDs.begin() + node * count, entityIDs.begin() + (node + 1) * count);
+			}
+		}
+		ComponentManagerBase::operationsFromID(componentID).addComponentCopies(sourceIDs.data(), copyIDs.data(), copyIDs.size());
+	});
+
+	// Copied transforms were reset to roots once added, so rebuild the hierarchy between the copies
+	for (unsigned int node = 1; node < nodeIDs.size(); node++)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			EntityID parentID = entityIDs[parentNodes[node] * count + i];
+			Entity child(entityIDs[node * count + i]);
+			if (hierarchy2D)
+				transform2DManager.getComponent(parentID).addChild(child);
+			else
+				transformManager.getComponent(parentID).addChild(child);
+		}
+	}
+
+	return std::vector<EntityID>(entityIDs.begin(), entityIDs.begin() + count);
+}
\ No newline at end of file
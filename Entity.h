@@ -1,40 +1,124 @@
 #pragma once
-#include "Vulkan.h"
+#include "Composition.h"
+#include "NamePool.h"
 #include <unordered_map>
 
+#define ENTITY_INDEX_BITS 24 // Number of low bits of an entity ID holding the index of the entity's slot, the remaining high bits hold the slot's generation
+#define ENTITY_INDEX_MASK ((1U << ENTITY_INDEX_BITS) - 1)
+
 typedef unsigned int EntityID;
 typedef unsigned int ComponentID;
-typedef unsigned long long Composition;
 
 template <typename T>
 class ComponentManager;
 
+// Tag component marking an entity as inactive, added and removed via Entity::deactivate and Entity::activate.
+struct Inactive {};
+
 class Entity
 {
 private:
 	template <typename T>
 	friend class ComponentManager;
 
-	// Dynamic array containing available IDs to use for new entties
-	static std::vector<EntityID> freeIDStack;
+	// Dynamic array containing the indices of destroyed entities' slots available to be reused by new entities
+	static std::vector<unsigned int> freeIndices;
+
+	/* Generation of each slot, incremented whenever the slot's entity is destroyed so IDs referring to the destroyed entity can be detected. 
+	   Slot 0 is reserved so that an ID of 0 never refers to an entity. */
+	static std::vector<unsigned char> generations;
+
+	// Composition of each slot's entity indicating which components each entity has, indexed by slot
+	static std::vector<Composition> compositions;
 
-	// Maps each entity ID to a Composition indicating which components each entity has
-	static std::unordered_map<EntityID, Composition> compositions;
+	#if ENTITY_NAMES
+	// Interned name of each slot's entity, indexed by slot. Kept separate from compositions as names are rarely accessed. 0 if the entity is unnamed
+	static std::vector<NameHandle> names;
 
-	// Maps each entity ID to a name for the entity
-	static std::unordered_map<EntityID, std::string> names;
+	// Position of each slot's entity within the array of entities sharing its name, indexed by slot
+	static std::vector<unsigned int> namePositions;
+
+	// IDs of the entities with each name, indexed by name handle. Unnamed entities are not indexed
+	static std::vector<std::vector<EntityID>> namedEntities;
+	#endif
 
 	EntityID mID; // Unique number identifying the entity
 
+	/*
+	Names an entity and moves it between the name index's arrays in constant time.
+	\param ID: ID of the entity.
+	\param name: Handle of the new name, 0 to leave the entity unnamed.
+	*/
+	static void assignName(const EntityID& ID, const NameHandle& name);
+
 public:
+	/*
+	\param ID: An entity ID.
+	\return The index of the slot the ID refers to.
+	*/
+	static unsigned int indexFromID(const EntityID& ID)
+	{
+		return ID & ENTITY_INDEX_MASK;
+	}
+
+	/*
+	\param ID: An entity ID.
+	\return The generation of the slot at the time the ID was created.
+	*/
+	static unsigned int generationFromID(const EntityID& ID)
+	{
+		return ID >> ENTITY_INDEX_BITS;
+	}
+
+	/*
+	Use to determine whether an ID refers to an entity which has not been destroyed.
+	\param ID: An entity ID.
+	\return True if the ID's slot is in use and of the same generation as the ID, otherwise false.
+	*/
+	static bool valid(const EntityID& ID)
+	{
+		unsigned int index = indexFromID(ID);
+		return index && index < generations.size() && generations[index] == generationFromID(ID);
+	}
+
 	/*
 	Get the composition of an entity via it's ID.
 	\param ID: An ID identifying an existing entity.
 	\return A reference to the entity's composition.
 	*/
-	static Composition& getCompositionFromID(const EntityID& ID);
+	static Composition& getCompositionFromID(const EntityID& ID)
+	{
+		assert(("[ERROR] Could not dereference ID", valid(ID)));
+		return compositions[indexFromID(ID)];
+	}
+
+	/*
+	Get the name of an entity via it's ID.
+	\param ID: An ID identifying an existing entity.
+	\return The entity's name, or "Entity " followed by the entity's slot index if it is unnamed.
+	*/
+	static std::string getNameFromID(const EntityID& ID);
 
-	static std::string& getNameFromID(const EntityID& ID);
+	/*
+	\param ID: An ID identifying an existing entity.
+	\return The handle of the entity's interned name, 0 if the entity is unnamed or ENTITY_NAMES is disabled.
+	*/
+	static NameHandle getNameHandleFromID(const EntityID& ID);
+
+	/*
+	Finds entities by name in constant time.
+	\param name: Name to search for.
+	\return IDs of every entity with the name, in no particular order. Always empty if ENTITY_NAMES is disabled.
+	*/
+	static const std::vector<EntityID>& findByName(const std::string_view& name);
+
+	/*
+	Creates several entities at once, reusing free slots before appending new ones in a single allocation.
+	\param entityIDs: Array to write the IDs of the created entities to.
+	\param count: Number of entities to create.
+	\param name: Handle of the interned name given to every created entity, 0 to leave them unnamed.
+	*/
+	static void createEntities(EntityID* entityIDs, const unsigned int& count, const NameHandle& name = 0);
 
 	Entity(const std::string& name = "");
 	
@@ -65,21 +149,24 @@ public:
 	const EntityID ID() const;
 
 	/*
-	Gets the composition of the entity. The Composition type is a bitmask indicating which components an entity possesses.
+	Gets the composition of the entity. The Composition type is a bitset indicating which components an entity possesses.
 	\return A reference to the entity's composition.
 	*/
-	const Composition& composition() const;
+	const Composition& composition() const
+	{
+		return compositions[indexFromID(mID)];
+	}
 
 	/*
-	Sets the name of the entity.
-	\param name: Name to assign to the entity.
+	Sets the name of the entity. Has no effect if ENTITY_NAMES is disabled.
+	\param name: Name to assign to the entity, empty to leave the entity unnamed.
 	*/
 	void setName(const std::string& name);
 
 	/*
-	\returns The name of the entity.
+	\returns The name of the entity, or "Entity " followed by the entity's slot index if it is unnamed.
 	*/
-	const std::string& name() const;
+	std::string name() const;
 
 	/*
 	Adds a component of type T to the entity. Only one component of each type may be added to an entity.
@@ -122,13 +209,29 @@ public:
 	bool hasComponent() const
 	{
 		static ComponentManager<T>& componentManager = ComponentManager<T>::instance();
-		return (composition() & componentManager.bit) == componentManager.bit;
+		return composition().test(componentManager.ID);
 	}
 
 	/*
 	\return The number of components the entity possesses.
 	*/
 	unsigned int nbComponents() const;
+
+	/*
+	Deactivates the entity and every entity in its transform hierarchy. Inactive entities keep their components, along with the GPU and physics resources systems
+	created for them, but are skipped by views and systems until reactivated. Subscribers are notified via the added event of ComponentManager<Inactive>.
+	*/
+	void deactivate() const;
+
+	/*
+	Reactivates the entity and every entity in its transform hierarchy. Subscribers are notified via the removed event of ComponentManager<Inactive>.
+	*/
+	void activate() const;
+
+	/*
+	\return False if the entity has been deactivated, otherwise true.
+	*/
+	bool active() const;
 };
 
 /*
@@ -153,4 +256,13 @@ Recursive method which destroys all children and children of children from an en
 effectively using transforms to maintain references to the children.
 \param entity : The entity whos children to destroy.
 */
-void destroyChildren(const Entity& entity);
\ No newline at end of file
+void destroyChildren(const Entity& entity);
+
+/*
+Creates copies of an entity and every entity in its transform hierarchy. Entities are created in one go and each component type is copied in a single batch,
+so subscribers are notified once per component type rather than once per copy. The copies' hierarchies mirror the prefab's.
+\param prefab: Root of the hierarchy to copy.
+\param count: Number of copies to create.
+\return The IDs of the copies of the prefab itself, children are accessible via their Transform or Transform2D components.
+*/
+std::vector<EntityID> instantiate(const Entity& prefab, const unsigned int& count);
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "EntityCommandBuffer.h"
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+	assert(("[ERROR] Entity command buffer destroyed before its commands were played back", mDestroyedIDs.empty()));
+	for (ComponentCommandQueueBase* queue : mQueues)
+		delete queue;
+}
+
+Entity EntityCommandBuffer::createEntity(const std::string& name)
+{
+	return Entity(name);
+}
+
+void EntityCommandBuffer::destroyEntity(const Entity& entity)
+{
+	mDestroyedIDs.push_back(entity.ID());
+}
+
+void EntityCommandBuffer::playback()
+{
+	for (ComponentCommandQueueBase* queue : mQueues)
+		queue->playbackAdded();
+	for (ComponentCommandQueueBase* queue : mQueues)
+		queue->playbackRemoved();
+
+	if (!mDestroyedIDs.empty())
+	{
+		// Group destroyed entities by the component types they possess so each type is removed in one batch
+		std::vector<EntityID> removedIDs[MAX_COMPONENTS];
+		Composition removedComposition;
+		for (const EntityID& entityID : mDestroyedIDs)
+		{
+			const Composition& composition = Entity::getCompositionFromID(entityID);
+			composition.forEach([&removedIDs, &entityID](const ComponentID& componentID)
+			{
+				removedIDs[componentID].push_back(entityID);
+			});
+			removedComposition |= composition;
+		}
+
+		removedComposition.forEach([&removedIDs](const ComponentID& componentID)
+		{
+			ComponentManagerBase::operationsFromID(componentID).removeComponents(removedIDs[componentID].data(), removedIDs[componentID].size());
+		});
+
+		// Entities no longer possess any components so destroying them only releases their IDs
+		for (const EntityID& entityID : mDestroyedIDs)
+			Entity(entityID).destroy();
+		mDestroyedIDs.clear();
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "ComponentManager.h"
+
+// Commands recorded for a single component type, type erased so they can be stored together.
+class ComponentCommandQueueBase
+{
+public:
+	virtual ~ComponentCommandQueueBase() {};
+
+	// Adds all recorded components in one batch.
+	virtual void playbackAdded() = 0;
+
+	// Removes all recorded components in one batch.
+	virtual void playbackRemoved() = 0;
+};
+
+template <typename T>
+class ComponentCommandQueue : public ComponentCommandQueueBase
+{
+public:
+	ComponentManager<T>& manager = ComponentManager<T>::instance();
+
+	std::vector<EntityID> addedIDs;
+	std::vector<T> addedComponents; // Parallel to addedIDs
+	std::vector<EntityID> removedIDs;
+
+	void playbackAdded() override
+	{
+		if (!addedIDs.empty())
+			manager.addComponents(addedIDs.data(), addedComponents.data(), addedIDs.size());
+		addedIDs.clear();
+		addedComponents.clear();
+	}
+
+	void playbackRemoved() override
+	{
+		if (!removedIDs.empty())
+			manager.removeComponents(removedIDs.data(), removedIDs.size());
+		removedIDs.clear();
+	}
+};
+
+/*
+Records structural changes to entities to be applied together at a later sync point, rather than immediately.
+Playback applies changes one component type at a time so each system is notified once per type with every affected entity,
+and changes recorded while iterating components do not invalidate the components being iterated.
+*/
+class EntityCommandBuffer
+{
+private:
+	std::vector<ComponentCommandQueueBase*> mQueues; // Command queues in the order their component type was first recorded
+	ComponentCommandQueueBase* mQueueMap[MAX_COMPONENTS] = {}; // Maps component IDs to their command queue, nullptr if nothing has been recorded for the type
+
+	std::vector<EntityID> mDestroyedIDs;
+
+	template <typename T>
+	ComponentCommandQueue<T>& queue()
+	{
+		static ComponentManager<T>& componentManager = ComponentManager<T>::instance();
+		ComponentCommandQueueBase*& queue = mQueueMap[componentManager.ID];
+		if (!queue)
+		{
+			queue = new ComponentCommandQueue<T>;
+			mQueues.push_back(queue);
+		}
+		return *(ComponentCommandQueue<T>*)queue;
+	}
+
+public:
+	EntityCommandBuffer() {};
+	EntityCommandBuffer(const EntityCommandBuffer& copy) = delete;
+	~EntityCommandBuffer();
+
+	/*
+	Creates an entity immediately so that its ID may be used by later commands. It possesses no components until the buffer is played back.
+	\param name: Name of the entity.
+	\return The created entity.
+	*/
+	Entity createEntity(const std::string& name = "");
+
+	/*
+	Records the destruction of an entity. All of its components are removed and its ID is released upon playback, after all other commands.
+	\param entity: Entity to destroy.
+	*/
+	void destroyEntity(const Entity& entity);
+
+	/*
+	Records the addition of a component to an entity.
+	\param entity: Entity to add the component to.
+	\param component: The component to be added. It's data is copied into the buffer.
+	*/
+	template <typename T>
+	void addComponent(const Entity& entity, T component)
+	{
+		ComponentCommandQueue<T>& componentQueue = queue<T>();
+		componentQueue.addedIDs.push_back(entity.ID());
+		componentQueue.addedComponents.push_back(std::move(component));
+	}
+
+	/*
+	Records the removal of a component of type T from an entity.
+	\param entity: Entity to remove the component from.
+	*/
+	template <typename T>
+	void removeComponent(const Entity& entity)
+	{
+		queue<T>().removedIDs.push_back(entity.ID());
+	}
+
+	/*
+	Applies all recorded commands and clears the buffer. Component additions are applied first, followed by removals then destructions,
+	each grouped by component type in the order the type was first recorded.
+	*/
+	void playback();
+};
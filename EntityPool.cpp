@@ -0,0 +1,64 @@
+#include "EntityPool.h"
+#include "ComponentManager.h"
+#include <algorithm>
+
+EntityPool::EntityPool(const Entity& prefab, const unsigned int& capacity) :
+	mPrefabID(prefab.ID())
+{
+	prefab.deactivate();
+	reserve(capacity);
+}
+
+void EntityPool::reserve(const unsigned int& count)
+{
+	assert(("[ERROR] Entity pool's prefab must remain inactive so that its copies are created inactive", !Entity(mPrefabID).active()));
+	if (count == 0)
+		return;
+
+	std::vector<EntityID> entityIDs = instantiate(Entity(mPrefabID), count);
+	mEntityIDs.insert(mEntityIDs.end(), entityIDs.begin(), entityIDs.end());
+	mInactiveIDs.insert(mInactiveIDs.end(), entityIDs.begin(), entityIDs.end());
+}
+
+Entity EntityPool::acquire()
+{
+	if (mInactiveIDs.empty())
+		reserve(std::max((unsigned int)mEntityIDs.size(), 1U));
+
+	Entity entity(mInactiveIDs.back());
+	mInactiveIDs.pop_back();
+	entity.activate();
+	return entity;
+}
+
+void EntityPool::release(const Entity& entity)
+{
+	assert(("[ERROR] Attempting to release an entity which is already inactive", entity.active()));
+	entity.deactivate();
+	mInactiveIDs.push_back(entity.ID());
+}
+
+unsigned int EntityPool::size() const
+{
+	return mEntityIDs.size();
+}
+
+unsigned int EntityPool::available() const
+{
+	return mInactiveIDs.size();
+}
+
+void EntityPool::destroy()
+{
+	for (const EntityID& entityID : mEntityIDs)
+	{
+		if (!Entity::valid(entityID))
+			continue;
+
+		Entity entity(entityID);
+		destroyChildren(entity);
+		entity.destroy();
+	}
+	mEntityIDs.clear();
+	mInactiveIDs.clear();
+}
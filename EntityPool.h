@@ -0,0 +1,56 @@
+#pragma once
+#include "Entity.h"
+
+/*
+Pool of inactive copies of a prefab entity. Acquiring reactivates a copy rather than creating an entity, and releasing deactivates it rather than destroying it,
+so the GPU and physics resources systems create for the copies' components are allocated once and reused.
+*/
+class EntityPool
+{
+private:
+	EntityID mPrefabID;
+
+	std::vector<EntityID> mEntityIDs; // Every copy created by the pool, acquired or not
+	std::vector<EntityID> mInactiveIDs; // Copies available to be acquired
+
+public:
+	/*
+	\param prefab: Entity copied, together with its transform hierarchy, to fill the pool. It is deactivated so that neither it nor its copies are simulated or rendered.
+	\param capacity: Number of copies to create up front.
+	*/
+	EntityPool(const Entity& prefab, const unsigned int& capacity = 0);
+	EntityPool(const EntityPool& copy) = delete;
+
+	/*
+	Creates inactive copies of the prefab in one batch.
+	\param count: Number of copies to create.
+	*/
+	void reserve(const unsigned int& count);
+
+	/*
+	Reactivates an inactive copy, doubling the number of copies if none are available.
+	\return The copy. Its components hold the values they had when it was released.
+	*/
+	Entity acquire();
+
+	/*
+	Deactivates a copy so it may be acquired again.
+	\param entity: Copy previously returned by acquire.
+	*/
+	void release(const Entity& entity);
+
+	/*
+	\return The number of copies created by the pool.
+	*/
+	unsigned int size() const;
+
+	/*
+	\return The number of copies available to be acquired.
+	*/
+	unsigned int available() const;
+
+	/*
+	Destroys every copy created by the pool, including those still acquired, along with their hierarchies. The prefab is left inactive.
+	*/
+	void destroy();
+};
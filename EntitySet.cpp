@@ -0,0 +1,76 @@
+#include "EntitySet.h"
+
+bool EntitySet::insert(const EntityID& entityID)
+{
+	unsigned int entityIndex = Entity::indexFromID(entityID);
+	if (entityIndex >= mSparse.size())
+		mSparse.resize(entityIndex + 1, SPARSE_EMPTY);
+	else if (mSparse[entityIndex] != SPARSE_EMPTY)
+	{
+		EntityID& existingID = mDense[mSparse[entityIndex]];
+		if (existingID == entityID)
+			return false;
+
+		// The slot's previous entity was destroyed without being erased, so the new entity takes its place
+		existingID = entityID;
+		return true;
+	}
+
+	mSparse[entityIndex] = mDense.size();
+	mDense.push_back(entityID);
+	return true;
+}
+
+bool EntitySet::erase(const EntityID& entityID)
+{
+	if (!contains(entityID))
+		return false;
+
+	// Move the last ID into the removed ID's position
+	unsigned int& index = mSparse[Entity::indexFromID(entityID)];
+	EntityID lastID = mDense.back();
+	mDense[index] = lastID;
+	mSparse[Entity::indexFromID(lastID)] = index;
+
+	mDense.pop_back();
+	index = SPARSE_EMPTY;
+	return true;
+}
+
+bool EntitySet::contains(const EntityID& entityID) const
+{
+	unsigned int entityIndex = Entity::indexFromID(entityID);
+	return entityIndex < mSparse.size() && mSparse[entityIndex] != SPARSE_EMPTY && mDense[mSparse[entityIndex]] == entityID;
+}
+
+void EntitySet::clear()
+{
+	for (const EntityID& entityID : mDense)
+		mSparse[Entity::indexFromID(entityID)] = SPARSE_EMPTY;
+	mDense.clear();
+}
+
+unsigned int EntitySet::size() const
+{
+	return mDense.size();
+}
+
+bool EntitySet::empty() const
+{
+	return mDense.empty();
+}
+
+const EntityID& EntitySet::operator[](const unsigned int& index) const
+{
+	return mDense[index];
+}
+
+const EntityID* EntitySet::begin() const
+{
+	return mDense.data();
+}
+
+const EntityID* EntitySet::end() const
+{
+	return mDense.data() + mDense.size();
+}
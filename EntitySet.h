@@ -0,0 +1,110 @@
+#pragma once
+#include "ComponentManager.h"
+#include <tuple>
+
+/*
+Set of entity IDs with constant time insertion, removal, and lookup. IDs are stored in a dense array iterated in order, and a sparse array indexed by entity slot
+holds the position of each ID within it. Removal moves the last ID into the removed ID's position so the dense array never contains gaps.
+*/
+class EntitySet
+{
+private:
+	std::vector<unsigned int> mSparse; // Position of each slot's entity ID in mDense, or SPARSE_EMPTY if the slot's entity is not in the set
+	std::vector<EntityID> mDense; // Entity IDs in the set
+
+public:
+	/*
+	Adds an entity to the set.
+	\param entityID: ID of the entity.
+	\return True if the entity was added, false if it was already in the set.
+	*/
+	bool insert(const EntityID& entityID);
+
+	/*
+	Removes an entity from the set.
+	\param entityID: ID of the entity.
+	\return True if the entity was removed, false if it was not in the set.
+	*/
+	bool erase(const EntityID& entityID);
+
+	/*
+	\param entityID: ID of the entity.
+	\return True if the entity is in the set, otherwise false. Always false if the ID refers to a destroyed entity whose slot's new entity is in the set.
+	*/
+	bool contains(const EntityID& entityID) const;
+
+	void clear();
+
+	unsigned int size() const;
+	bool empty() const;
+
+	const EntityID& operator[](const unsigned int& index) const;
+
+	const EntityID* begin() const;
+	const EntityID* end() const;
+};
+
+typedef std::function<void(const Entity&)> EntitySetCallback;
+
+/*
+Entity set kept up to date with every entity possessing all component types in Ts. Entities are inserted once a component is added which completes the composition,
+and erased before a component of the composition is removed, so systems need not maintain their own entity arrays.
+*/
+template <typename... Ts>
+class SystemEntitySet : public EntitySet
+{
+private:
+	std::tuple<ComponentManager<Ts>&...> mManagers;
+
+	Composition mComposition; // Composition an entity must contain to be in the set
+
+	EntitySetCallback mInsertedCallback;
+	EntitySetCallback mErasedCallback;
+
+	const ComponentAddedCallback mComponentAddedCallback = std::bind(&SystemEntitySet::componentAdded, this, std::placeholders::_1);
+	const ComponentRemovedCallback mComponentRemovedCallback = std::bind(&SystemEntitySet::componentRemoved, this, std::placeholders::_1);
+
+	void componentAdded(const Entity& entity)
+	{
+		if (entity.composition().contains(mComposition) && insert(entity.ID()) && mInsertedCallback)
+			mInsertedCallback(entity);
+	}
+
+	void componentRemoved(const Entity& entity)
+	{
+		if (!contains(entity.ID()))
+			return;
+
+		if (mErasedCallback)
+			mErasedCallback(entity);
+		erase(entity.ID());
+	}
+
+public:
+	/*
+	\param insertedCallback: Procedure invoked after an entity is inserted, or nullptr. Must follow template: void [procedure name](const Entity& [entity name]).
+	\param erasedCallback: Procedure invoked before an entity is erased while it still possesses all components, or nullptr. Must follow the same template.
+	*/
+	SystemEntitySet(const EntitySetCallback& insertedCallback = nullptr, const EntitySetCallback& erasedCallback = nullptr) :
+		mManagers(ComponentManager<Ts>::instance()...), mComposition((ComponentManager<Ts>::instance().bit | ...)), mInsertedCallback(insertedCallback), mErasedCallback(erasedCallback)
+	{
+		(std::get<ComponentManager<Ts>&>(mManagers).subscribeAddedEvent(&mComponentAddedCallback), ...);
+		(std::get<ComponentManager<Ts>&>(mManagers).subscribeRemovedEvent(&mComponentRemovedCallback), ...);
+	}
+
+	SystemEntitySet(const SystemEntitySet& copy) = delete;
+
+	~SystemEntitySet()
+	{
+		(std::get<ComponentManager<Ts>&>(mManagers).unsubscribeAddedEvent(&mComponentAddedCallback), ...);
+		(std::get<ComponentManager<Ts>&>(mManagers).unsubscribeRemovedEvent(&mComponentRemovedCallback), ...);
+	}
+
+	/*
+	\return The composition an entity must contain to be in the set.
+	*/
+	const Composition& composition() const
+	{
+		return mComposition;
+	}
+};
@@ -68,7 +68,7 @@ InteractSystem::~InteractSystem()
 
 void InteractSystem::componentAdded(const Entity& entity)
 {
-	if ((entity.composition() & mInteractorComposition) == mInteractorComposition)
+	if (entity.composition().contains(mInteractorComposition))
 		mInteractor = entity.ID();
 }
 
@@ -80,7 +80,7 @@ void InteractSystem::componentRemoved(const Entity& entity)
 
 void InteractSystem::interactableComponentAdded(const Entity& entity)
 {
-	if ((entity.composition() & mInteractableComposition) == mInteractableComposition)
+	if (entity.composition().contains(mInteractableComposition))
 	{
 		entity.getComponent<Interactable>().interactCallbacks.initialize();
 	}
@@ -88,7 +88,7 @@ void InteractSystem::interactableComponentAdded(const Entity& entity)
 
 void InteractSystem::interactableComponentRemoved(const Entity& entity)
 {
-	if ((entity.composition() & mInteractableComposition) == mInteractableComposition)
+	if (entity.composition().contains(mInteractableComposition))
 	{
 		entity.getComponent<Interactable>().interactCallbacks.free();
 	}
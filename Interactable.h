@@ -23,6 +23,12 @@ struct Interactor
 	float interactDistance;
 };
 
+template <>
+struct Reflection<Interactor>
+{
+	static constexpr FieldInfo fields[] = { REFLECT_FIELD(Interactor, interactDistance) };
+};
+
 class InteractSystem
 {
 private:
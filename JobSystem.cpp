@@ -0,0 +1,240 @@
+#include "JobSystem.h"
+#include <climits>
+
+thread_local unsigned int JobSystem::threadIndex = UINT_MAX; // Threads which are not part of the job system have no index
+
+JobSystem::JobSystem() :
+	mNQueuedJobs(0), mStop(false)
+{
+	threadIndex = 0; // Constructed by the main thread
+	startWorkers(JOB_THREADS);
+}
+
+JobSystem& JobSystem::instance()
+{
+	static JobSystem instance;
+	return instance;
+}
+
+JobSystem::~JobSystem()
+{
+	stopWorkers();
+	for (JobQueue* queue : mQueues)
+		delete queue;
+}
+
+void JobSystem::startWorkers(const unsigned int& nThreads)
+{
+	mQueues.resize(nThreads ? nThreads : std::max(std::thread::hardware_concurrency(), 1U));
+	for (JobQueue*& queue : mQueues)
+		queue = new JobQueue;
+
+	// The main thread is thread 0 so only create the remaining threads
+	for (unsigned int i = 1; i < mQueues.size(); i++)
+		mWorkers.emplace_back(&JobSystem::work, this, i);
+}
+
+void JobSystem::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		mStop = true;
+	}
+	mJobQueued.notify_all();
+	for (std::thread& worker : mWorkers)
+		worker.join();
+	mWorkers.clear();
+	mStop = false;
+}
+
+void JobSystem::setThreadCount(const unsigned int& nThreads)
+{
+	assert(("[ERROR] Thread count must be changed from the main thread", threadIndex == 0));
+	stopWorkers();
+
+	// Run jobs left queued by the workers before their deques are destroyed
+	while (tryRunJob());
+	for (JobQueue* queue : mQueues)
+		delete queue;
+	mQueues.clear();
+
+	startWorkers(nThreads);
+}
+
+unsigned int JobSystem::currentThread()
+{
+	return threadIndex;
+}
+
+unsigned int JobSystem::nThreads() const
+{
+	return mQueues.size();
+}
+
+void JobSystem::work(const unsigned int& thread)
+{
+	threadIndex = thread;
+	while (true)
+	{
+		if (tryRunJob())
+			continue;
+
+		std::unique_lock<std::mutex> lock(mSleepMutex);
+		mJobQueued.wait(lock, [this]() { return mStop || mNQueuedJobs.load(std::memory_order_acquire) > 0; });
+		if (mStop)
+			return;
+	}
+}
+
+void JobSystem::enqueue(JobEntry&& entry, const bool& mainThread)
+{
+	if (mainThread)
+	{
+		std::lock_guard<std::mutex> lock(mMainThreadQueue.mutex);
+		mMainThreadQueue.jobs.push_back(std::move(entry));
+		return;
+	}
+
+	// Threads which are not part of the job system share the main thread's deque
+	JobQueue& queue = *mQueues[threadIndex < mQueues.size() ? threadIndex : 0];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(entry));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		mNQueuedJobs++;
+	}
+	mJobQueued.notify_one();
+}
+
+bool JobSystem::tryRunJob()
+{
+	JobEntry entry;
+
+	if (threadIndex == 0)
+	{
+		std::unique_lock<std::mutex> lock(mMainThreadQueue.mutex);
+		if (!mMainThreadQueue.jobs.empty())
+		{
+			entry = std::move(mMainThreadQueue.jobs.front());
+			mMainThreadQueue.jobs.pop_front();
+			lock.unlock();
+
+			execute(entry);
+			return true;
+		}
+	}
+
+	// Pop the most recently queued job of the thread's own deque, which is most likely to still be in cache, otherwise steal the oldest job of another deque
+	unsigned int thread = threadIndex < mQueues.size() ? threadIndex : 0;
+	for (unsigned int i = 0; i < mQueues.size(); i++)
+	{
+		JobQueue& queue = *mQueues[(thread + i) % mQueues.size()];
+		std::unique_lock<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+			continue;
+
+		if (i == 0)
+		{
+			entry = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+		else
+		{
+			entry = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+		lock.unlock();
+		mNQueuedJobs--;
+
+		execute(entry);
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::execute(JobEntry& entry)
+{
+	entry.job();
+	if (entry.counter)
+		complete(entry.counter);
+}
+
+void JobSystem::complete(JobCounter* counter)
+{
+	// Decrement while locked so waiters, which lock the counter once it reaches zero, cannot destroy it while it is still in use
+	std::vector<JobCounter::Continuation> continuations;
+	{
+		std::lock_guard<std::mutex> lock(counter->mMutex);
+		if (counter->mCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+		continuations.swap(counter->mContinuations); // Counter reached zero so release its dependent jobs
+	}
+	for (JobCounter::Continuation& continuation : continuations)
+		enqueue({ std::move(continuation.job), continuation.counter }, continuation.mainThread);
+}
+
+void JobSystem::schedule(const Job& job, JobCounter* counter, const bool& mainThread)
+{
+	if (counter)
+		counter->mCount.fetch_add(1, std::memory_order_relaxed);
+	enqueue({ job, counter }, mainThread);
+}
+
+void JobSystem::scheduleAfter(JobCounter& dependency, const Job& job, JobCounter* counter, const bool& mainThread)
+{
+	if (counter)
+		counter->mCount.fetch_add(1, std::memory_order_relaxed);
+
+	{
+		std::lock_guard<std::mutex> lock(dependency.mMutex);
+		if (!dependency.done())
+		{
+			dependency.mContinuations.push_back({ job, counter, mainThread });
+			return;
+		}
+	}
+	enqueue({ job, counter }, mainThread);
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+	while (!counter.done())
+	{
+		if (!tryRunJob())
+			std::this_thread::yield(); // Remaining jobs are being run by other threads
+	}
+	std::lock_guard<std::mutex> lock(counter.mMutex); // Wait for the thread completing the last job to release the counter
+}
+
+void JobSystem::parallelFor(const unsigned int& begin, const unsigned int& end, const unsigned int& grainSize, const RangeJob& function)
+{
+	assert(("[ERROR] Parallel for grain size must be greater than 0", grainSize > 0));
+
+	JobCounter counter;
+	for (unsigned int batchBegin = begin; batchBegin < end; batchBegin += grainSize)
+	{
+		unsigned int batchEnd = std::min(batchBegin + grainSize, end);
+		schedule([&function, batchBegin, batchEnd]() { function(batchBegin, batchEnd); }, &counter);
+	}
+	wait(counter);
+}
+
+void JobSystem::runMainThreadJobs()
+{
+	assert(("[ERROR] Main thread jobs must be run from the main thread", threadIndex == 0));
+	while (true)
+	{
+		JobEntry entry;
+		{
+			std::lock_guard<std::mutex> lock(mMainThreadQueue.mutex);
+			if (mMainThreadQueue.jobs.empty())
+				return;
+			entry = std::move(mMainThreadQueue.jobs.front());
+			mMainThreadQueue.jobs.pop_front();
+		}
+		execute(entry);
+	}
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include "Vulkan.h"
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+
+typedef std::function<void()> Job;
+typedef std::function<void(const unsigned int& begin, const unsigned int& end)> RangeJob;
+
+class JobSystem;
+
+/*
+Counts unfinished jobs. Jobs scheduled with a counter increment it and decrement it once complete, so waiting for a counter to reach zero waits for all of its jobs.
+Jobs may also be scheduled to start once a counter reaches zero, expressing dependencies between groups of jobs.
+*/
+class JobCounter
+{
+private:
+	friend JobSystem;
+
+	struct Continuation
+	{
+		Job job;
+		JobCounter* counter;
+		bool mainThread;
+	};
+
+	std::atomic<unsigned int> mCount;
+
+	std::mutex mMutex;
+	std::vector<Continuation> mContinuations; // Jobs to schedule once the count reaches zero
+
+public:
+	JobCounter() : mCount(0) {};
+	JobCounter(const JobCounter& copy) = delete;
+
+	/*
+	\return True if all jobs of the counter have completed, otherwise false.
+	*/
+	bool done() const
+	{
+		return mCount.load(std::memory_order_acquire) == 0;
+	}
+};
+
+/*
+Pool of worker threads executing jobs. Each thread owns a deque of jobs, pushing and popping jobs at the back, and steals jobs from the front of other threads'
+deques once its own is empty. Jobs with main thread affinity, such as those calling GLFW or submitting to Vulkan queues, are only run by the main thread.
+Threads waiting on a counter execute other jobs until the counter reaches zero.
+*/
+class JobSystem
+{
+private:
+	struct JobEntry
+	{
+		Job job;
+		JobCounter* counter;
+	};
+
+	struct JobQueue
+	{
+		std::mutex mutex;
+		std::deque<JobEntry> jobs;
+	};
+
+	static thread_local unsigned int threadIndex;
+
+	std::vector<std::thread> mWorkers;
+	std::vector<JobQueue*> mQueues; // One per thread, indexed by thread index. The main thread's index is 0
+	JobQueue mMainThreadQueue; // Jobs which may only be run by the main thread
+
+	std::atomic<unsigned int> mNQueuedJobs; // Number of jobs in mQueues, used to put idle workers to sleep
+	std::mutex mSleepMutex;
+	std::condition_variable mJobQueued;
+	std::atomic<bool> mStop;
+
+	JobSystem();
+
+	// Creates a deque per thread and the worker threads. 0 threads creates one per hardware thread.
+	void startWorkers(const unsigned int& nThreads);
+
+	// Wakes the workers and waits for them to exit. Jobs may remain queued.
+	void stopWorkers();
+
+	void work(const unsigned int& thread);
+
+	void enqueue(JobEntry&& entry, const bool& mainThread);
+
+	// Runs a job with main thread affinity if called from the main thread, then a job from the calling thread's deque, otherwise a job stolen from another thread.
+	bool tryRunJob();
+
+	// Executes a job and completes it on its counter.
+	void execute(JobEntry& entry);
+
+	void complete(JobCounter* counter);
+
+public:
+	static JobSystem& instance();
+
+	JobSystem(const JobSystem& copy) = delete;
+	~JobSystem();
+
+	/*
+	\return The index of the calling thread. The main thread is 0, workers are numbered from 1, and threads which are not part of the job system are UINT_MAX.
+	*/
+	static unsigned int currentThread();
+
+	/*
+	\return The number of threads executing jobs, including the main thread.
+	*/
+	unsigned int nThreads() const;
+
+	/*
+	Replaces the worker threads, waiting for queued jobs to complete first. Must be called from the main thread while no job is waiting on a counter.
+	\param nThreads: Number of threads executing jobs including the main thread, 0 to use one per hardware thread.
+	*/
+	void setThreadCount(const unsigned int& nThreads);
+
+	/*
+	Queues a job to be executed.
+	\param job: Procedure to execute.
+	\param counter: Counter incremented now and decremented once the job completes, or nullptr.
+	\param mainThread: Whether the job may only be run by the main thread.
+	*/
+	void schedule(const Job& job, JobCounter* counter = nullptr, const bool& mainThread = false);
+
+	/*
+	Queues a job to be executed once all jobs of another counter have completed.
+	\param dependency: Counter to wait for.
+	\param job: Procedure to execute.
+	\param counter: Counter incremented now and decremented once the job completes, or nullptr.
+	\param mainThread: Whether the job may only be run by the main thread.
+	*/
+	void scheduleAfter(JobCounter& dependency, const Job& job, JobCounter* counter = nullptr, const bool& mainThread = false);
+
+	/*
+	Executes jobs on the calling thread until all jobs of a counter have completed.
+	\param counter: Counter to wait for.
+	*/
+	void wait(JobCounter& counter);
+
+	/*
+	Splits a range into batches and executes them in parallel, returning once all batches have completed.
+	\param begin: First index of the range.
+	\param end: One past the last index of the range.
+	\param grainSize: Maximum number of indices per batch.
+	\param function: Procedure invoked for each batch. Must follow template: void [procedure name](const unsigned int& [begin name], const unsigned int& [end name]).
+	*/
+	void parallelFor(const unsigned int& begin, const unsigned int& end, const unsigned int& grainSize, const RangeJob& function);
+
+	// Runs all queued jobs with main thread affinity. Must be called from the main thread.
+	void runMainThreadJobs();
+};
@@ -6,8 +6,489 @@
 #include "FontManager.h"
 #include "InventoryManager.h"
 #include "SceneMenu.h"
+#include "Scheduler.h"
 #include <chrono>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+#if COMPONENT_BENCHMARK
+// Component pool indexed by an unordered_map from entity IDs to indices, as ComponentManager was before the sparse set, compared against by benchmarkComponents.
+template <typename T>
+struct MapComponentPool
+{
+	std::unordered_map<EntityID, unsigned int> entityIndexMap;
+	std::vector<T> components;
+	std::vector<EntityID> entityIDs; // Owner of each component, so removal does not scan the map for the owner of the last component
+
+	void addComponent(const EntityID& entityID, const T& component)
+	{
+		entityIndexMap[entityID] = components.size();
+		components.push_back(component);
+		entityIDs.push_back(entityID);
+	}
+
+	T& getComponent(const EntityID& entityID)
+	{
+		return components[entityIndexMap.at(entityID)];
+	}
+
+	void removeComponent(const EntityID& entityID)
+	{
+		std::unordered_map<EntityID, unsigned int>::iterator it = entityIndexMap.find(entityID);
+		entityIndexMap[entityIDs.back()] = it->second;
+		components[it->second] = components.back();
+		entityIDs[it->second] = entityIDs.back();
+		components.pop_back();
+		entityIDs.pop_back();
+		entityIndexMap.erase(it);
+	}
+};
+
+/*
+Adds, gets in random order, iterates, and removes in random order the interactors of freshly created entities, with ComponentManager and with an
+unordered_map indexed pool, and prints the time taken by each operation with both.
+\param nEntities: Number of entities to create.
+*/
+void benchmarkComponents(const unsigned int& nEntities)
+{
+	ComponentManager<Interactor>& manager = ComponentManager<Interactor>::instance();
+	MapComponentPool<Interactor> mapPool;
+
+	std::vector<EntityID> entityIDs(nEntities);
+	Entity::createEntities(entityIDs.data(), nEntities);
+	std::vector<EntityID> shuffledIDs = entityIDs;
+	std::shuffle(shuffledIDs.begin(), shuffledIDs.end(), std::mt19937(0));
+
+	double managerTimes[4];
+	double mapTimes[4];
+	float managerSum = 0.0f;
+	float mapSum = 0.0f;
+
+	// Add
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (const EntityID& entityID : entityIDs)
+		manager.addComponent(Entity(entityID), Interactor{ 1.0f });
+	managerTimes[0] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	for (const EntityID& entityID : entityIDs)
+		mapPool.addComponent(entityID, Interactor{ 1.0f });
+	mapTimes[0] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	// Get
+	start = std::chrono::high_resolution_clock::now();
+	for (const EntityID& entityID : shuffledIDs)
+		managerSum += manager.readComponent(entityID).interactDistance;
+	managerTimes[1] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	for (const EntityID& entityID : shuffledIDs)
+		mapSum += mapPool.getComponent(entityID).interactDistance;
+	mapTimes[1] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	// Iterate
+	start = std::chrono::high_resolution_clock::now();
+	View<const Interactor>().each([&](const EntityID& entityID, const Interactor& interactor) { managerSum += interactor.interactDistance; });
+	managerTimes[2] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	for (const Interactor& interactor : mapPool.components)
+		mapSum += interactor.interactDistance;
+	mapTimes[2] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	assert(("[ERROR] Component pools disagree", managerSum == mapSum));
+
+	// Remove
+	start = std::chrono::high_resolution_clock::now();
+	for (const EntityID& entityID : shuffledIDs)
+		manager.removeComponent(Entity(entityID));
+	managerTimes[3] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	for (const EntityID& entityID : shuffledIDs)
+		mapPool.removeComponent(entityID);
+	mapTimes[3] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	const char* operations[4] = { "add", "get", "iterate", "remove" };
+	std::cout << nEntities << " components:";
+	for (unsigned int i = 0; i < 4; i++)
+		std::cout << " " << operations[i] << " " << managerTimes[i] << "ms sparse set, " << mapTimes[i] << "ms map" << (i < 3 ? ";" : "");
+	std::cout << " (" << managerSum << ")" << std::endl;
+
+	for (const EntityID& entityID : entityIDs)
+		Entity(entityID).destroy();
+}
+#endif
+
+#if JOB_BENCHMARK
+/*
+Schedules chains of dependent jobs, some with main thread affinity and each spawning a nested job, and asserts every job ran exactly once, after the jobs it
+depends on, and on the main thread where required.
+\param nChains: Number of independent chains.
+\param chainLength: Number of stages in each chain, each scheduled to start once the previous stage has completed.
+\param stageSize: Number of jobs in each stage, excluding nested jobs.
+*/
+void stressJobs(const unsigned int& nChains, const unsigned int& chainLength, const unsigned int& stageSize)
+{
+	JobSystem& jobSystem = JobSystem::instance();
+
+	// Each job and its nested job have adjacent run counts
+	std::vector<std::atomic<unsigned int>> runCounts(nChains * chainLength * stageSize * 2);
+	std::unique_ptr<JobCounter[]> stageCounters(new JobCounter[nChains * chainLength]);
+
+	for (unsigned int chain = 0; chain < nChains; chain++)
+	{
+		for (unsigned int stage = 0; stage < chainLength; stage++)
+		{
+			const unsigned int stageIndex = chain * chainLength + stage;
+			for (unsigned int i = 0; i < stageSize; i++)
+			{
+				const unsigned int jobIndex = (stageIndex * stageSize + i) * 2;
+				const bool mainThread = jobIndex % 14 == 0;
+				Job job = [&, stage, stageIndex, jobIndex, mainThread]()
+				{
+					assert(("[ERROR] Main thread job ran on a worker", !mainThread || JobSystem::currentThread() == 0));
+					if (stage > 0)
+					{
+						for (unsigned int previous = (stageIndex - 1) * stageSize * 2; previous < stageIndex * stageSize * 2; previous++)
+							assert(("[ERROR] Job ran before the jobs it depends on", runCounts[previous].load() == 1));
+					}
+					runCounts[jobIndex]++;
+
+					// Scheduled while the job's counter is still held, so dependent stages also wait for it
+					jobSystem.schedule([&, jobIndex]() { runCounts[jobIndex + 1]++; }, &stageCounters[stageIndex]);
+				};
+
+				if (stage == 0)
+					jobSystem.schedule(job, &stageCounters[stageIndex], mainThread);
+				else
+					jobSystem.scheduleAfter(stageCounters[stageIndex - 1], job, &stageCounters[stageIndex], mainThread);
+			}
+		}
+	}
+
+	for (unsigned int chain = 0; chain < nChains; chain++)
+		jobSystem.wait(stageCounters[chain * chainLength + chainLength - 1]);
+
+	for (const std::atomic<unsigned int>& runCount : runCounts)
+		assert(("[ERROR] Job did not run exactly once", runCount.load() == 1));
+}
+
+/*
+Prints the time taken by a fixed parallelFor workload and by stressJobs at every thread count from 1 up to one per hardware thread. The job system is returned
+to JOB_THREADS threads afterwards.
+\param count: Number of indices of the parallelFor workload.
+\param nRepetitions: Number of times to run the workload, the time being averaged over them.
+*/
+void benchmarkJobs(const unsigned int& count, const unsigned int& nRepetitions)
+{
+	JobSystem& jobSystem = JobSystem::instance();
+	std::vector<float> results(count);
+
+	double singleThreadTime = 0.0;
+	const unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1U);
+	for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads++)
+	{
+		jobSystem.setThreadCount(nThreads);
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		for (unsigned int repetition = 0; repetition < nRepetitions; repetition++)
+		{
+			jobSystem.parallelFor(0, count, 4096, [&](const unsigned int& begin, const unsigned int& end)
+			{
+				for (unsigned int i = begin; i < end; i++)
+					results[i] = std::sqrt((float)i) * std::sin((float)i + repetition);
+			});
+		}
+		double parallelForTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / nRepetitions;
+		if (nThreads == 1)
+			singleThreadTime = parallelForTime;
+
+		start = std::chrono::high_resolution_clock::now();
+		stressJobs(64, 16, 8);
+		double stressTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		std::cout << nThreads << " threads: parallelFor " << parallelForTime << "ms (" << singleThreadTime / parallelForTime << "x), stress " << stressTime << "ms" << std::endl;
+	}
+
+	jobSystem.setThreadCount(JOB_THREADS);
+}
+#endif
+
+#if INSTANTIATION_BENCHMARK
+/*
+Loads a model as a prefab, instantiates copies of it, and prints the time taken. Asserts every copy's meshes have their own buffers holding the same vertices and
+indices as the prefab's.
+\param directory: Model to load.
+\param count: Number of copies to create.
+*/
+void benchmarkInstantiation(const char* directory, const unsigned int& count)
+{
+	Entity prefab = loadModel(directory);
+	std::vector<Mesh*> prefabMeshes = getComponentsInHierarchy3D<Mesh>(prefab);
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::vector<EntityID> copyIDs = instantiate(prefab, count);
+	double time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	for (const EntityID& copyID : copyIDs)
+	{
+		std::vector<Mesh*> meshes = getComponentsInHierarchy3D<Mesh>(Entity(copyID));
+		assert(("[ERROR] Copy's hierarchy has a different number of meshes to the prefab's", meshes.size() == prefabMeshes.size()));
+		for (unsigned int i = 0; i < meshes.size(); i++)
+		{
+			const Mesh& mesh = *meshes[i];
+			const Mesh& prefabMesh = *prefabMeshes[i];
+			assert(("[ERROR] Copied mesh shares the prefab's buffers", mesh._vertexBuffer != prefabMesh._vertexBuffer && mesh.vertices != prefabMesh.vertices));
+			assert(("[ERROR] Copied mesh's size differs from the prefab's", mesh.nVertices == prefabMesh.nVertices && mesh.nIndices == prefabMesh.nIndices));
+			assert(("[ERROR] Copied mesh's vertices differ from the prefab's", !memcmp(mesh.vertices, prefabMesh.vertices, mesh.nVertices * sizeof(Vertex))));
+			assert(("[ERROR] Copied mesh's indices differ from the prefab's", !memcmp(mesh.indices, prefabMesh.indices, mesh.nIndices * sizeof(unsigned int))));
+		}
+	}
+
+	std::cout << count << " copies of " << directory << ": " << time << "ms" << std::endl;
+
+	for (const EntityID& copyID : copyIDs)
+	{
+		Entity copy(copyID);
+		destroyChildren(copy);
+		copy.destroy();
+	}
+	destroyChildren(prefab);
+	prefab.destroy();
+}
+#endif
+
+#if SERIALIZATION_BENCHMARK
+/*
+Serializes the components of freshly created entities one at a time, then as a whole pool, and prints the throughput of both. The pool is then deserialized onto
+new entities, which are checked to have components identical to the originals.
+\param component: Component added to each entity.
+\param nEntities: Number of entities to create.
+*/
+template <typename T>
+void benchmarkSerialization(const T& component, const unsigned int& nEntities)
+{
+	ComponentManager<T>& manager = ComponentManager<T>::instance();
+
+	std::vector<EntityID> entityIDs(nEntities);
+	Entity::createEntities(entityIDs.data(), nEntities);
+	std::vector<T> components(nEntities, component);
+	manager.addComponents(entityIDs.data(), components.data(), nEntities);
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::vector<char> perComponent;
+	for (const EntityID& entityID : entityIDs)
+	{
+		std::vector<char> vecData = manager.getSerializedComponent(entityID);
+		perComponent.insert(perComponent.end(), vecData.begin(), vecData.end());
+	}
+	double perComponentTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	std::vector<char> pool;
+	manager.serializePool(pool);
+	double poolTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+	// Pool layout: component count, IDs of the owning entities, then the block written by serializeComponents
+	const char* read = pool.data();
+	unsigned int count;
+	memcpy(&count, read, sizeof(unsigned int));
+	read += sizeof(unsigned int) + count * sizeof(EntityID);
+	assert(("[ERROR] Serialized pool holds a different number of components", count == nEntities));
+
+	std::vector<EntityID> copyIDs(count);
+	Entity::createEntities(copyIDs.data(), count);
+
+	start = std::chrono::high_resolution_clock::now();
+	manager.addSerializedComponents(read, copyIDs.data(), count);
+	double deserializeTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	assert(("[ERROR] Deserialization did not consume the whole pool", read == pool.data() + pool.size()));
+
+	// The pool is in storage order, which need not match the order entityIDs were created in
+	const EntityID* pooledIDs = reinterpret_cast<const EntityID*>(pool.data() + sizeof(unsigned int));
+	for (unsigned int i = 0; i < count; i++)
+		assert(("[ERROR] Deserialized component differs from the serialized one", manager.getSerializedComponent(copyIDs[i]) == manager.getSerializedComponent(pooledIDs[i])));
+
+	std::cout << manager.componentName << ": per component " << perComponent.size() / perComponentTime / 1e6 << " MB/s, pool " << pool.size() / poolTime / 1e6 << " MB/s, pool deserialization " << pool.size() / deserializeTime / 1e6 << " MB/s" << std::endl;
+
+	for (const EntityID& entityID : entityIDs)
+		Entity(entityID).destroy();
+	for (const EntityID& copyID : copyIDs)
+		Entity(copyID).destroy();
+}
+#endif
+
+#if TRANSFORM_BENCHMARK
+/*
+Creates transforms arranged in chains, moves the root of some chains each update, and prints the average time taken to propagate the changes.
+\param nChains: Number of chains, each chain's root is a root transform.
+\param chainLength: Number of transforms in each chain, 1 for a flat scene.
+\param nUpdates: Number of updates to average over.
+\param nMoving: Number of chains moved each update. The remaining chains are static, like level geometry.
+*/
+void benchmarkTransforms(const unsigned int& nChains, const unsigned int& chainLength, const unsigned int& nUpdates, const unsigned int& nMoving)
+{
+	TransformSystem& transformSystem = TransformSystem::instance();
+	ComponentManager<Transform>& transformManager = ComponentManager<Transform>::instance();
+
+	std::vector<EntityID> entityIDs(nChains * chainLength);
+	Entity::createEntities(entityIDs.data(), entityIDs.size());
+	std::vector<Transform> transforms(entityIDs.size(), TransformCreateInfo{ glm::vec3(0.0f, 1.0f, 0.0f) });
+	for (unsigned int i = nMoving * chainLength; i < transforms.size(); i++)
+		transforms[i].dynamic = false;
+	transformManager.addComponents(entityIDs.data(), transforms.data(), entityIDs.size());
+	for (unsigned int chain = 0; chain < nChains; chain++)
+	{
+		for (unsigned int i = 1; i < chainLength; i++)
+			transformManager.getComponent(entityIDs[chain * chainLength + i - 1]).addChild(Entity(entityIDs[chain * chainLength + i]));
+	}
+	transformSystem.updateTransforms(); // Flatten the hierarchy outside of the timed updates
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (unsigned int update = 0; update < nUpdates; update++)
+	{
+		for (unsigned int chain = 0; chain < nMoving; chain++)
+			transformManager.getComponent(entityIDs[chain * chainLength]).translate(glm::vec3(0.01f, 0.0f, 0.0f));
+		transformSystem.updateTransforms();
+	}
+	double movingTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / nUpdates;
+
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int update = 0; update < nUpdates; update++)
+		transformSystem.updateTransforms();
+	double idleTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / nUpdates;
+
+	std::cout << nChains << " chains of " << chainLength << " transforms, " << nMoving << " moving: " << movingTime << "ms moving, " << idleTime << "ms idle" << std::endl;
+
+	for (const EntityID& entityID : entityIDs)
+		Entity(entityID).destroy();
+	transformSystem.updateTransforms();
+}
+
+/*
+Composes random transforms' matrices and normal matrices with the batched kernel and with glm, checks the results agree, and prints the throughput of both.
+\param count: Number of transforms to compose.
+*/
+void benchmarkMatrixComposition(const unsigned int& count)
+{
+	std::vector<glm::vec3> positions(count);
+	std::vector<glm::quat> rotations(count);
+	std::vector<glm::vec3> scales(count);
+	std::vector<unsigned int> indices(count);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		positions[i] = glm::vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100);
+		rotations[i] = glm::angleAxis((float)rand(), glm::normalize(glm::vec3(rand() % 100 + 1, rand() % 100 - 50, rand() % 100 - 50)));
+		scales[i] = glm::vec3(rand() % 100 + 1, rand() % 100 + 1, rand() % 100 + 1) / 25.0f;
+		indices[i] = i;
+	}
+
+	std::vector<glm::mat4> matrices(count);
+	std::vector<glm::mat3> normalMatrices(count);
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	composeTransforms(positions.data(), rotations.data(), scales.data(), indices.data(), count, matrices.data(), normalMatrices.data());
+	double batchedTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+	std::vector<glm::mat4> glmMatrices(count);
+	std::vector<glm::mat3> glmNormalMatrices(count);
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < count; i++)
+	{
+		glmMatrices[i] = glm::translate(glm::mat4(1.0f), positions[i]) * glm::mat4_cast(rotations[i]) * glm::scale(glm::mat4(1.0f), scales[i]);
+		glmNormalMatrices[i] = glm::mat3(glm::transpose(glm::inverse(glmMatrices[i])));
+	}
+	double glmTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+	// Largest difference relative to the magnitude of the element compared
+	float error = 0.0f;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		for (unsigned int column = 0; column < 4; column++)
+		{
+			for (unsigned int row = 0; row < 4; row++)
+			{
+				error = std::max(error, std::abs(matrices[i][column][row] - glmMatrices[i][column][row]) / (1.0f + std::abs(glmMatrices[i][column][row])));
+				if (column < 3 && row < 3)
+					error = std::max(error, std::abs(normalMatrices[i][column][row] - glmNormalMatrices[i][column][row]) / (1.0f + std::abs(glmNormalMatrices[i][column][row])));
+			}
+		}
+	}
+	assert(("[ERROR] Batched transform composition disagrees with glm", error < 1e-4f));
+
+	std::cout << "Matrix composition (" << BATCH_WIDTH << " wide): " << count / batchedTime / 1e6 << " M/s batched, " << count / glmTime / 1e6 << " M/s glm, max relative error " << error << std::endl;
+}
+#endif
+
+#if PHYSICS_BENCHMARK
+/*
+Drops columns of dynamic convex boxes onto a static floor and prints the average time taken to simulate a step, once for each thread count from 1 up to one
+per hardware thread. The job system is returned to JOB_THREADS threads afterwards.
+\param nBodies: Number of dynamic rigid bodies to simulate.
+\param nSteps: Number of steps to average over, each starting from the same scene.
+*/
+void benchmarkPhysics(const unsigned int& nBodies, const unsigned int& nSteps)
+{
+	JobSystem& jobSystem = JobSystem::instance();
+	PhysicsSystem& physicsSystem = PhysicsSystem::instance();
+	ComponentManager<Transform>& transformManager = ComponentManager<Transform>::instance();
+	ComponentManager<RigidBody>& rigidBodyManager = ComponentManager<RigidBody>::instance();
+
+	static glm::vec3 boxVertices[8] = { { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f },
+		{ -0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, 0.5f }, { -0.5f, 0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f } };
+	const unsigned int columnHeight = 8;
+	const unsigned int rowLength = (unsigned int)std::ceil(std::sqrt((float)nBodies / columnHeight));
+
+	std::vector<unsigned int> threadCounts;
+	const unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1U);
+	for (unsigned int nThreads = 1; nThreads < maxThreads; nThreads *= 2)
+		threadCounts.push_back(nThreads);
+	threadCounts.push_back(maxThreads);
+
+	for (const unsigned int& nThreads : threadCounts)
+	{
+		jobSystem.setThreadCount(nThreads);
+
+		Entity floor("Benchmark floor");
+		floor.addComponent<Transform>(TransformCreateInfo{ glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(rowLength * 2.0f, 1.0f, rowLength * 2.0f) });
+		floor.addComponent<RigidBody>(StaticRigidBodyCreateInfo{ boxVertices, 8, nullptr, 0, 8, { 0.5f, 0.5f, 0.6f } });
+
+		// Columns are slightly offset so they topple into each other
+		std::vector<EntityID> entityIDs(nBodies);
+		Entity::createEntities(entityIDs.data(), entityIDs.size());
+		std::vector<Transform> transforms(nBodies);
+		for (unsigned int i = 0; i < nBodies; i++)
+		{
+			const unsigned int column = i / columnHeight;
+			glm::vec3 position(column % rowLength * 1.5f - rowLength * 0.75f, 1.0f + i % columnHeight * 1.1f, column / rowLength * 1.5f - rowLength * 0.75f);
+			position.x += (i % 3) * 0.1f;
+			transforms[i] = TransformCreateInfo{ position };
+		}
+		transformManager.addComponents(entityIDs.data(), transforms.data(), nBodies);
+		RigidBody rigidBody = DynamicRigidBodyCreateInfo{ boxVertices, 8, 8, { 0.5f, 0.5f, 0.6f }, 1.0f };
+		std::vector<RigidBody> rigidBodies(nBodies, rigidBody);
+		rigidBodyManager.addComponents(entityIDs.data(), rigidBodies.data(), nBodies);
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		for (unsigned int step = 0; step < nSteps; step++)
+		{
+			physicsSystem.beginStep(PHYSICS_TIMESTEP);
+			physicsSystem.endStep();
+		}
+		double stepTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / nSteps;
+
+		std::cout << nBodies << " dynamic bodies on " << nThreads << " threads: " << stepTime << "ms per step" << std::endl;
+
+		for (const EntityID& entityID : entityIDs)
+			Entity(entityID).destroy();
+		floor.destroy();
+	}
+
+	jobSystem.setThreadCount(JOB_THREADS);
+}
+#endif
 
 int main()
 {
@@ -32,6 +513,35 @@ int main()
 	#endif
 	/* -------------- */
 
+	#if COMPONENT_BENCHMARK
+	benchmarkComponents(100000);
+	#endif
+
+	#if JOB_BENCHMARK
+	benchmarkJobs(1 << 22, 10);
+	#endif
+
+	#if INSTANTIATION_BENCHMARK
+	benchmarkInstantiation("Assets/AK103/AK_103.fbx", 100);
+	#endif
+
+	#if SERIALIZATION_BENCHMARK
+	benchmarkSerialization(Interactor{ 10.0f }, 100000);
+	benchmarkSerialization(CameraController{ 1.0f, 0.005f, true, true, true }, 100000);
+	benchmarkSerialization<Transform>(TransformCreateInfo{}, 100000);
+	#endif
+
+	#if TRANSFORM_BENCHMARK
+	benchmarkTransforms(100000, 1, 100, 100000); // Wide, flat scene
+	benchmarkTransforms(100, 1000, 100, 100); // Deep chains
+	benchmarkTransforms(50000, 1, 100, 100); // Static level with few moving objects
+	benchmarkMatrixComposition(1000000);
+	#endif
+
+	#if PHYSICS_BENCHMARK
+	benchmarkPhysics(5000, 300);
+	#endif
+
 	renderSystem.setSkybox(&TextureManager::instance().getCubemap({ { "Images/Skybox/right.hdr", "Images/Skybox/left.hdr", "Images/Skybox/bottom.hdr", "Images/Skybox/top.hdr", "Images/Skybox/front.hdr", "Images/Skybox/back.hdr" }, FORMAT_RGBA_HDR16 }));
 
 
@@ -93,17 +603,37 @@ int main()
 
 	*/
 
+	/* SCHEDULING */
+	// Systems are listed in the order they must run when their component accesses conflict
+	Scheduler& scheduler = Scheduler::instance();
+	scheduler.addSystem({ "Transform", [&](const double& deltaTime) { transformSystem.updateTransforms(); },
+		{}, componentComposition<Transform>(), false });
+	scheduler.addSystem({ "Transform2D", [&](const double& deltaTime) { transformSystem.updateTransforms2D(); },
+		{}, componentComposition<Transform2D>(), false });
+	// Camera, render, and physics consume the transform changes of the frame so must read Transform
+	// Physics simulates on PhysX's threads between beginning and ending its step, overlapping with the camera and render updates which conflict with both
+	scheduler.addSystem({ "Physics begin", [&](const double& deltaTime) { physicsSystem.beginStep(deltaTime); },
+		{}, componentComposition<Transform, RigidBody, CharacterController>(), true });
+	scheduler.addSystem({ "Camera", [&](const double& deltaTime) { cameraSystem.update(); },
+		componentComposition<Transform>(), componentComposition<Camera>(), false });
+	scheduler.addSystem({ "Render", [&](const double& deltaTime) { renderSystem.update(); },
+		componentComposition<Transform, Transform2D, Camera, Sprite, UIText>(), componentComposition<Mesh, DirectionalLight, UIButton>(), true });
+	scheduler.addSystem({ "Physics end", [&](const double& deltaTime) { physicsSystem.endStep(); },
+		{}, componentComposition<Transform, RigidBody, CharacterController>(), true });
+	scheduler.addSystem({ "Camera controller", [&](const double& deltaTime) { cameraControllerSystem.update(deltaTime); },
+		componentComposition<CameraController>(), componentComposition<Transform>(), true });
+	/* -------------- */
+
 	std::chrono::high_resolution_clock::time_point now, last = std::chrono::high_resolution_clock::now();
 	while (!windowManager.windowClosed())
 	{
 		now = std::chrono::high_resolution_clock::now();
 		double deltaTime = std::chrono::duration<double>(now - last).count();
 
-		transformSystem.update();
-		renderSystem.update();
-		cameraSystem.update();
-		physicsSystem.update(deltaTime);
-		cameraControllerSystem.update(deltaTime);
+		scheduler.run(deltaTime);
+		#if SCHEDULER_TRACE
+		scheduler.printTrace();
+		#endif
 
 		windowManager.pollEvents();
 
@@ -334,31 +334,9 @@ UIButtonCreateInfo::operator UIButton() const
 
 RenderSystem::RenderSystem()
 {
-	// Subcribe to managers to recieve events
-	mTransformManager.subscribeAddedEvent(&mTransformAddedCallback);
-	mTransformManager.subscribeRemovedEvent(&mTransformRemovedCallback);
-	mMeshManager.subscribeAddedEvent(&mMeshAddedCallback);
-	mMeshManager.subscribeRemovedEvent(&mMeshRemovedCallback);
-	mDirectionalLightManager.subscribeAddedEvent(&mDirectionalLightAddedCallback);
-	mDirectionalLightManager.subscribeRemovedEvent(&mDirectionalLightRemovedCallback);
-	mTransform2DManager.subscribeAddedEvent(&mTransform2DAddedCallback);
-	mTransform2DManager.subscribeRemovedEvent(&mTransform2DRemovedCallback);
-	mSpriteManager.subscribeAddedEvent(&mSpriteAddedCallback);
-	mSpriteManager.subscribeRemovedEvent(&mSpriteRemovedCallback);
-	mUITextManager.subscribeAddedEvent(&mUITextAddedCallback);
-	mUITextManager.subscribeRemovedEvent(&mUITextRemovedCallback);
-	mUIButtonManager.subscribeAddedEvent(&mUIButtonAddedCallback);
-	mUIButtonManager.subscribeRemovedEvent(&mUIButtonRemovedCallback);
+	// Subcribe to window manager to recieve events
 	mWindowManager.subscribeLMBPressedEvent(&mLMBPressedCallback);
 
-	// Compositions define criteria for entities to be included in the system
-	mMeshComposition = mTransformManager.bit | mMeshManager.bit;
-	mDirectionalLightComposition = mTransformManager.bit | mDirectionalLightManager.bit;
-
-	mSpriteComposition = mTransform2DManager.bit | mSpriteManager.bit;
-	mUITextComposition = mTransform2DManager.bit | mUITextManager.bit;
-	mUIButtonComposition = mTransform2DManager.bit | mUIButtonManager.bit;
-
 	// Write constants to shader before compiling
 	// Demonstrates how shaders could be configured and compiled at runtime
 	std::vector<char> fragmentSource = readFile("ShaderSource/shader.frag");
@@ -2162,10 +2140,22 @@ void RenderSystem::addMesh(const Entity& entity)
 	unsigned int localMemoryType = memoryTypeFromProperties(mPhysicalDeviceMemoryProperties, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 	unsigned int hostMemoryType = memoryTypeFromProperties(mPhysicalDeviceMemoryProperties, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
+	// Copies of another mesh, such as those made by instantiate, still point at the original's CPU side buffers, whose contents are uploaded to the copy's own buffers
+	const Vertex* sourceVertices = mesh.vertices;
+	const unsigned int* sourceIndices = mesh.indices;
+
 	mesh._vertexBuffer = VK_NULL_HANDLE;
 	mesh._indexBuffer = VK_NULL_HANDLE;
 	if (mesh.nVertices != 0 && mesh.nIndices != 0)
+	{
 		allocateMeshBuffers(mesh);
+		if (sourceVertices && sourceIndices)
+		{
+			memcpy(mesh.vertices, sourceVertices, mesh.nVertices * sizeof(Vertex));
+			memcpy(mesh.indices, sourceIndices, mesh.nIndices * sizeof(unsigned int));
+			mesh.updateBuffers();
+		}
+	}
 
 	// Create uniform buffer - stores model and normal matrices
 	unsigned int uniformBufferRange = sizeof(glm::mat4) * 2;
@@ -2239,16 +2229,12 @@ void RenderSystem::addMesh(const Entity& entity)
 	if(mesh.material.albedo && mesh.material.normal && mesh.material.roughness && mesh.material.metalness && mesh.material.ambientOcclusion)
 		mesh.updateMaterial();
 
-	Transform& transform = entity.getComponent<Transform>();
-	transform.subscribeChangedEvent(&mMeshTransformChangedCallback);
-	meshTransformChanged(transform);
-
-	mMeshIDs.push_back(entity.ID());
+	uploadTransforms({ { entity.ID(), POSITION_CHANGED | ROTATION_CHANGED | SCALE_CHANGED } });
 }
 
-void RenderSystem::removeMesh(const std::vector<EntityID>::iterator& IDIterator)
+void RenderSystem::removeMesh(const Entity& entity)
 {
-	Mesh& mesh = mMeshManager.getComponent(*IDIterator);
+	Mesh& mesh = entity.getComponent<Mesh>();
 
 	vkFreeMemory(mDevice, mesh._vertexMemory, nullptr);
 	vkDestroyBuffer(mDevice, mesh._vertexBuffer, nullptr);
@@ -2266,12 +2252,6 @@ void RenderSystem::removeMesh(const std::vector<EntityID>::iterator& IDIterator)
 	vkFreeMemory(mDevice, mesh._uniformStagingMemory, nullptr);
 	vkDestroyBuffer(mDevice, mesh._uniformStagingBuffer, nullptr);
 	vkFreeDescriptorSets(mDevice, mDescriptorPool, 1, &mesh._descriptorSet);
-
-	Transform& transform = mTransformManager.getComponent(*IDIterator);
-	if(transform.changedCallbacks.data) // Incase the transform has already been freed
-		transform.unsubscribeChangedEvent(&mMeshTransformChangedCallback);
-
-	mMeshIDs.erase(IDIterator);
 }
 
 void RenderSystem::addDirectionalLight(const Entity& entity)
@@ -2349,16 +2329,12 @@ void RenderSystem::addDirectionalLight(const Entity& entity)
 
 	directionalLightChanged(directionalLight);
 
-	Transform& transform = entity.getComponent<Transform>();
-	transform.subscribeChangedEvent(&mDirectionalLightTransformChangedCallback);
-	directionalLightTransformChanged(transform);
-
-	mDirectionalLightIDs.push_back(entity.ID());
+	uploadTransforms({ { entity.ID(), POSITION_CHANGED | ROTATION_CHANGED | SCALE_CHANGED } });
 }
 
-void RenderSystem::removeDirectionalLight(const std::vector<EntityID>::iterator& IDIterator)
+void RenderSystem::removeDirectionalLight(const Entity& entity)
 {
-	DirectionalLight& directionalLight = mDirectionalLightManager.getComponent(*IDIterator);
+	DirectionalLight& directionalLight = entity.getComponent<DirectionalLight>();
 
 	vkFreeMemory(mDevice, directionalLight._uniformMemory, nullptr);
 	vkDestroyBuffer(mDevice, directionalLight._uniformBuffer, nullptr);
@@ -2366,12 +2342,6 @@ void RenderSystem::removeDirectionalLight(const std::vector<EntityID>::iterator&
 	vkFreeMemory(mDevice, directionalLight._uniformStagingMemory, nullptr);
 	vkDestroyBuffer(mDevice, directionalLight._uniformStagingBuffer, nullptr);
 	vkFreeDescriptorSets(mDevice, mDescriptorPool, 1, &directionalLight._descriptorSet);
-
-	Transform& transform = mTransformManager.getComponent(*IDIterator);
-	if(transform.changedCallbacks.data) // Incase the transform has already been freed
-		transform.unsubscribeChangedEvent(&mDirectionalLightTransformChangedCallback);
-
-	mDirectionalLightIDs.erase(IDIterator);
 }
 
 void RenderSystem::addSprite(const Entity& entity)
@@ -2406,17 +2376,12 @@ void RenderSystem::addSprite(const Entity& entity)
 	descriptorSetWrite.pImageInfo = &imageInfo;
 	vkUpdateDescriptorSets(mDevice, 1, &descriptorSetWrite, 0, nullptr);
     #pragma endregion
-
-	mSpriteIDs.push_back(entity.ID());
 }
 
-void RenderSystem::removeSprite(const std::vector<EntityID>::iterator& IDIterator)
+void RenderSystem::removeSprite(const Entity& entity)
 {
-	EntityID ID = *IDIterator;
-	Sprite& sprite = mSpriteManager.getComponent(ID);
+	Sprite& sprite = entity.getComponent<Sprite>();
 	vkFreeDescriptorSets(mDevice, mDescriptorPool, 1, &sprite._descriptorSet);
-
-	mSpriteIDs.erase(std::find(mSpriteIDs.begin(), mSpriteIDs.end(), ID));
 }
 
 void RenderSystem::addUIButton(const Entity& entity)
@@ -2471,19 +2436,14 @@ void RenderSystem::addUIButton(const Entity& entity)
 	uiButton._canpressDescriptorSet = sets[1];
 	uiButton._pressedDescriptorSet = sets[2];
 	#pragma endregion
-
-	mUIButtonIDs.push_back(entity.ID());
 }
 
-void RenderSystem::removeUIButton(const std::vector<EntityID>::iterator& IDIterator)
+void RenderSystem::removeUIButton(const Entity& entity)
 {
-	EntityID ID = *IDIterator;
-	UIButton& uiButton = mUIButtonManager.getComponent(ID);
+	UIButton& uiButton = entity.getComponent<UIButton>();
 
 	VkDescriptorSet descriptorSets[3] = { uiButton._unpressedDescriptorSet, uiButton._canpressDescriptorSet, uiButton._pressedDescriptorSet };
 	vkFreeDescriptorSets(mDevice, mDescriptorPool, 3, descriptorSets);
-
-	mUIButtonIDs.erase(std::find(mUIButtonIDs.begin(), mUIButtonIDs.end(), ID));
 }
 
 RenderSystem& RenderSystem::instance()
@@ -2494,18 +2454,6 @@ RenderSystem& RenderSystem::instance()
 
 RenderSystem::~RenderSystem()
 {
-	mTransformManager.unsubscribeAddedEvent(&mTransformAddedCallback);
-	mTransformManager.unsubscribeRemovedEvent(&mTransformRemovedCallback);
-	mMeshManager.unsubscribeAddedEvent(&mMeshAddedCallback);
-	mMeshManager.unsubscribeRemovedEvent(&mMeshRemovedCallback);
-	mDirectionalLightManager.unsubscribeAddedEvent(&mDirectionalLightAddedCallback);
-	mDirectionalLightManager.unsubscribeRemovedEvent(&mDirectionalLightRemovedCallback);
-	mTransform2DManager.unsubscribeAddedEvent(&mTransform2DAddedCallback);
-	mTransform2DManager.unsubscribeRemovedEvent(&mTransform2DRemovedCallback);
-	mUITextManager.unsubscribeAddedEvent(&mUITextAddedCallback);
-	mUITextManager.unsubscribeRemovedEvent(&mUITextRemovedCallback);
-	mUIButtonManager.unsubscribeAddedEvent(&mUIButtonAddedCallback);
-	mUIButtonManager.unsubscribeRemovedEvent(&mUIButtonRemovedCallback);
 	mWindowManager.unsubscribeLMBPressedEvent(&mLMBPressedCallback);
 
 	vkDestroySemaphore(mDevice, mRenderComplete, nullptr);
@@ -2576,182 +2524,64 @@ RenderSystem::~RenderSystem()
 	delete[] mPhysicalDevices, mSwapchainImageViews, mFramebuffers, mPrefilterImageViews, mPrefilterFramebuffers;
 }
 
-void RenderSystem::transformAdded(const Entity& entity)
-{
-	const Composition& entityComposition = entity.composition();
-	if ((entityComposition & mMeshComposition) == mMeshComposition)
-		addMesh(entity);
-	else if ((entityComposition & mDirectionalLightComposition) == mDirectionalLightComposition)
-		addDirectionalLight(entity);
-}
-
-void RenderSystem::transformRemoved(const Entity& entity)
-{
-	std::vector<EntityID>::iterator IDIterator = std::find(mMeshIDs.begin(), mMeshIDs.end(), entity.ID());
-	if (IDIterator != mMeshIDs.end())
-		removeMesh(IDIterator);
-	IDIterator = std::find(mDirectionalLightIDs.begin(), mDirectionalLightIDs.end(), entity.ID());
-	if (IDIterator != mDirectionalLightIDs.end())
-		removeDirectionalLight(IDIterator);
-}
-
-void RenderSystem::meshAdded(const Entity& entity)
-{
-	if ((entity.composition() & mMeshComposition) == mMeshComposition)
-		addMesh(entity);
-}
-
-void RenderSystem::meshRemoved(const Entity& entity)
-{
-	std::vector<EntityID>::iterator IDIterator = std::find(mMeshIDs.begin(), mMeshIDs.end(), entity.ID());
-	if (IDIterator != mMeshIDs.end())
-		removeMesh(IDIterator);
-}
-
-void RenderSystem::directionalLightAdded(const Entity& entity)
-{
-	if ((entity.composition() & mDirectionalLightComposition) == mDirectionalLightComposition)
-		addDirectionalLight(entity);
-}
-
-void RenderSystem::directionalLightRemoved(const Entity& entity)
-{
-	std::vector<EntityID>::iterator IDIterator = std::find(mDirectionalLightIDs.begin(), mDirectionalLightIDs.end(), entity.ID());
-	if (IDIterator != mDirectionalLightIDs.end())
-		removeDirectionalLight(IDIterator);
-}
-
-void RenderSystem::transform2DAdded(const Entity& entity)
-{
-	const Composition& entityComposition = entity.composition();
-	if ((entityComposition & mSpriteComposition) == mSpriteComposition)
-		addSprite(entity);
-	else if ((entityComposition & mUITextComposition) == mUITextComposition)
-		mUITextIDs.push_back(entity.ID());
-	else if ((entityComposition & mUIButtonComposition) == mUIButtonComposition)
-		addUIButton(entity);
-}
-
-void RenderSystem::transform2DRemoved(const Entity& entity)
-{
-	std::vector<EntityID>::iterator IDIterator = std::find(mSpriteIDs.begin(), mSpriteIDs.end(), entity.ID());
-	if (IDIterator != mSpriteIDs.end())
-	{
-		removeSprite(IDIterator);
-		return;
-	}
-	IDIterator = std::find(mUITextIDs.begin(), mUITextIDs.end(), entity.ID());
-	if (IDIterator != mUITextIDs.end())
-	{
-		mUITextIDs.erase(IDIterator);
-		return;
-	}
-	IDIterator = std::find(mUIButtonIDs.begin(), mUIButtonIDs.end(), entity.ID());
-	if (IDIterator != mUIButtonIDs.end())
-		removeUIButton(IDIterator);
-}
-
-void RenderSystem::spriteAdded(const Entity& entity)
-{
-	if ((entity.composition() & mSpriteComposition) == mSpriteComposition)
-		addSprite(entity);
-}
-
-void RenderSystem::spriteRemoved(const Entity& entity)
-{
-	std::vector<EntityID>::iterator IDIterator = std::find(mSpriteIDs.begin(), mSpriteIDs.end(), entity.ID());
-	if (IDIterator != mSpriteIDs.end())
-		removeSprite(IDIterator);
-}
-
-void RenderSystem::UITextAdded(const Entity& entity)
-{
-	if((entity.composition() & mUITextComposition) == mUITextComposition)
-		mUITextIDs.push_back(entity.ID());
-}
-
-void RenderSystem::UITextRemoved(const Entity& entity)
-{
-	std::vector<EntityID>::iterator IDIterator = std::find(mUITextIDs.begin(), mUITextIDs.end(), entity.ID());
-	if(IDIterator != mUITextIDs.end())
-		mUITextIDs.erase(IDIterator);
-}
-
-void RenderSystem::UIButtonAdded(const Entity& entity)
+void RenderSystem::uploadTransforms(const std::vector<TransformChange>& changes) const
 {
-	if ((entity.composition() & mUIButtonComposition) == mUIButtonComposition)
-		addUIButton(entity);
-}
-
-void RenderSystem::UIButtonRemoved(const Entity& entity)
-{
-	std::vector<EntityID>::iterator IDIterator = std::find(mUIButtonIDs.begin(), mUIButtonIDs.end(), entity.ID());
-	if (IDIterator != mUIButtonIDs.end())
-		removeUIButton(IDIterator);
-}
-
-void RenderSystem::meshTransformChanged(Transform& transform) const
-{
-	// Update GPU side model and normal matrices
-	Mesh& mesh = mMeshManager.getComponent(transform.entityID);
-	memcpy(mesh._uniformData, &transform.matrix, sizeof(glm::mat4));
-	glm::mat4 normalMatrix = glm::transpose(glm::inverse(transform.matrix));
-	memcpy(mesh._uniformData + sizeof(glm::mat4), &normalMatrix, sizeof(glm::mat4));
-
-	#pragma region Copy staging buffer to device local buffer
 	VkCommandBufferBeginInfo commandBufferBeginInfo = {};
 	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	commandBufferBeginInfo.pNext = nullptr;
 	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 	commandBufferBeginInfo.pInheritanceInfo = nullptr;
-	vkBeginCommandBuffer(mCommandBuffer, &commandBufferBeginInfo);
-
-	VkBufferCopy copyRegion = {};
-	copyRegion.srcOffset = 0;
-	copyRegion.dstOffset = 0;
-	copyRegion.size = sizeof(glm::mat4) * 2;
-	vkCmdCopyBuffer(mCommandBuffer, mesh._uniformStagingBuffer, mesh._uniformBuffer, 1, &copyRegion);
-
-	vkEndCommandBuffer(mCommandBuffer);
 
-	VkSubmitInfo submitInfo = {};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.pNext = nullptr;
-	submitInfo.waitSemaphoreCount = 0;
-	submitInfo.pWaitSemaphores = nullptr;
-	submitInfo.pWaitDstStageMask = nullptr;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &mCommandBuffer;
-	submitInfo.signalSemaphoreCount = 0;
-	submitInfo.pSignalSemaphores = nullptr;
-	vkQueueSubmit(mGraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+	// Record copies of all changed transforms into one command buffer, only beginning it once there is something to copy
+	bool recording = false;
+	for (const TransformChange& change : changes)
+	{
+		bool isMesh = mMeshIDs.contains(change.entityID);
+		bool isDirectionalLight = (change.flags & ROTATION_CHANGED) && mDirectionalLightIDs.contains(change.entityID); // Only the direction of a light depends on its transform
+		if (!isMesh && !isDirectionalLight)
+			continue;
 
-	vkQueueWaitIdle(mGraphicsQueue);
-	vkResetCommandBuffer(mCommandBuffer, 0);
-	#pragma endregion
-}
+		if (!recording)
+		{
+			vkBeginCommandBuffer(mCommandBuffer, &commandBufferBeginInfo);
+			recording = true;
+		}
 
-void RenderSystem::directionalLightTransformChanged(Transform& transform) const
-{
-	// Update GPU side direction vector
-	DirectionalLight& directionalLight = mDirectionalLightManager.getComponent(transform.entityID);
-	glm::vec3 direction = transform.worldDirection();
-	memcpy(directionalLight._uniformData + sizeof(glm::vec3), &direction, sizeof(glm::vec3));
+		const Transform& transform = mTransformManager.readComponent(change.entityID);
+		if (isMesh)
+		{
+			// Update GPU side model and normal matrices
+			const Mesh& mesh = mMeshManager.readComponent(change.entityID);
+			memcpy(mesh._uniformData, &transform.matrix, sizeof(glm::mat4));
+			glm::mat4 normalMatrix = glm::mat4(transform.normalMatrix); // Maintained by the transform system, the shader only uses its upper 3x3
+			memcpy(mesh._uniformData + sizeof(glm::mat4), &normalMatrix, sizeof(glm::mat4));
+
+			VkBufferCopy copyRegion = {};
+			copyRegion.srcOffset = 0;
+			copyRegion.dstOffset = 0;
+			copyRegion.size = sizeof(glm::mat4) * 2;
+			vkCmdCopyBuffer(mCommandBuffer, mesh._uniformStagingBuffer, mesh._uniformBuffer, 1, &copyRegion);
+		}
 
-	#pragma region Copy staging buffer to device local buffer
-	VkCommandBufferBeginInfo commandBufferBeginInfo = {};
-	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	commandBufferBeginInfo.pNext = nullptr;
-	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-	commandBufferBeginInfo.pInheritanceInfo = nullptr;
-	vkBeginCommandBuffer(mCommandBuffer, &commandBufferBeginInfo);
+		if (isDirectionalLight)
+		{
+			// Update GPU side direction vector
+			const DirectionalLight& directionalLight = mDirectionalLightManager.readComponent(change.entityID);
+			glm::vec3 direction = transform.worldDirection();
+			memcpy(directionalLight._uniformData + sizeof(glm::vec3), &direction, sizeof(glm::vec3));
+
+			VkBufferCopy copyRegion = {};
+			copyRegion.srcOffset = sizeof(glm::vec3);
+			copyRegion.dstOffset = 16; // vec3 requires 12 bytes but it's alignment is 16 bytes
+			copyRegion.size = sizeof(glm::vec3);
+			vkCmdCopyBuffer(mCommandBuffer, directionalLight._uniformStagingBuffer, directionalLight._uniformBuffer, 1, &copyRegion);
+		}
+	}
 
-	VkBufferCopy copyRegion = {};
-	copyRegion.srcOffset = sizeof(glm::vec3);
-	copyRegion.dstOffset = 16; // vec3 requires 12 bytes but it's alignment is 16 bytes
-	copyRegion.size = sizeof(glm::vec3);
-	vkCmdCopyBuffer(mCommandBuffer, directionalLight._uniformStagingBuffer, directionalLight._uniformBuffer, 1, &copyRegion);
+	if (!recording)
+		return;
 
+	#pragma region Submit copies
 	vkEndCommandBuffer(mCommandBuffer);
 
 	VkSubmitInfo submitInfo = {};
@@ -2817,8 +2647,7 @@ void RenderSystem::cameraProjectionChanged(const Camera& camera)
 void RenderSystem::cameraViewChanged(const Transform& transform, const Camera& camera)
 {
 	memcpy(mUniformData + sizeof(glm::mat4), &camera.viewMatrix, sizeof(glm::mat4));
-	if (transform.positionChanged)
-		memcpy(mUniformData + 2 * sizeof(glm::mat4), &transform.worldPosition, sizeof(glm::vec3));
+	memcpy(mUniformData + 2 * sizeof(glm::mat4), &transform.worldPosition, sizeof(glm::vec3));
 }
 
 void RenderSystem::LMBPressed()
@@ -2828,6 +2657,9 @@ void RenderSystem::LMBPressed()
 
 	for (const EntityID& entity : mUIButtonIDs)
 	{
+		if (!Entity(entity).active())
+			continue;
+
 		UIButton& uiButton = mUIButtonManager.getComponent(entity);
 		if (uiButton._underCursor)
 		{
@@ -2841,6 +2673,8 @@ void RenderSystem::LMBPressed()
 
 void RenderSystem::update()
 {
+	uploadTransforms(mTransformSystem.changes());
+
 	/* TEMPORARY FIX: FONT MUST BE LOADED BEFORE RENDER PASS */
 	const Font* font = nullptr;
 	if (!mUITextIDs.empty())
@@ -2866,17 +2700,19 @@ void RenderSystem::update()
 	
 	for (const EntityID& directionalLightID : mDirectionalLightIDs)
 	{
+		if (!Entity(directionalLightID).active())
+			continue;
+
 		vkCmdBindDescriptorSets(mCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mDirectionalPipelineLayout, 2, 1, &mDirectionalLightManager.getComponent(directionalLightID)._descriptorSet, 0, nullptr);
 
-		for (const EntityID& meshID : mMeshIDs)
+		mMeshView.each([&](const EntityID& meshID, const Mesh& mesh, const Transform& transform)
 		{
-			Mesh& mesh = mMeshManager.getComponent(meshID);
 			vkCmdBindDescriptorSets(mCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mDirectionalPipelineLayout, 1, 1, &mesh._descriptorSet, 0, nullptr);
 			vkCmdBindVertexBuffers(mCommandBuffer, 0, 1, &mesh._vertexBuffer, &ZERO_OFFSET);
 			vkCmdBindIndexBuffer(mCommandBuffer, mesh._indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
 			vkCmdDrawIndexed(mCommandBuffer, mesh.nIndices, 1, 0, 0, 0);
-		}
+		});
 	}
 
 	// Render skybox
@@ -2900,11 +2736,8 @@ void RenderSystem::update()
 	// Sprites
 	unsigned int text = false;
 	vkCmdPushConstants(mCommandBuffer, m2DPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 76, sizeof(unsigned int), &text);
-	for (const EntityID& entity : mSpriteIDs)
+	mSpriteView.each([&](const EntityID& entity, const Sprite& sprite, const Transform2D& transform)
 	{
-		Transform2D& transform = mTransform2DManager.getComponent(entity);
-		Sprite& sprite = mSpriteManager.getComponent(entity);
-
 		glm::mat4 matrix = m2DProjection * transform.matrix * glm::scale(glm::mat4(1.0f), glm::vec3(sprite.width, sprite.height, 1.0f));
 		vkCmdPushConstants(mCommandBuffer, m2DPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &matrix[0][0]);
 		glm::vec3 colour(1.0f);
@@ -2912,15 +2745,11 @@ void RenderSystem::update()
 
 		vkCmdBindDescriptorSets(mCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m2DPipelineLayout, 0, 1, &sprite._descriptorSet, 0, nullptr);
 		vkCmdDraw(mCommandBuffer, 4, 1, 0, 0);
-	}
+	});
 
 	// Buttons
-	for (const EntityID& entity : mUIButtonIDs)
+	mUIButtonView.each([&](const EntityID& entity, UIButton& uiButton, const Transform2D& transform)
 	{
-		Transform2D& transform = mTransform2DManager.getComponent(entity);
-
-		UIButton& uiButton = mUIButtonManager.getComponent(entity);
-
 		glm::mat4 transformMatrix = transform.matrix * glm::scale(glm::mat4(1.0f), glm::vec3(uiButton.width, uiButton.height, 1.0f));
 		glm::mat4 matrix = m2DProjection * transformMatrix;
 		vkCmdPushConstants(mCommandBuffer, m2DPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &matrix[0][0]);
@@ -2982,17 +2811,14 @@ void RenderSystem::update()
 		}
 
 		vkCmdDraw(mCommandBuffer, 4, 1, 0, 0);
-	}
+	});
 
 	// Text
 	text = true;
 	vkCmdPushConstants(mCommandBuffer, m2DPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 76, sizeof(unsigned int), &text);
 
-	for (const EntityID& entity : mUITextIDs)
+	mUITextView.each([&](const EntityID& entity, const UIText& uiText, const Transform2D& transform)
 	{
-		Transform2D& transform = mTransform2DManager.getComponent(entity);
-		UIText& uiText = mUITextManager.getComponent(entity);
-
 		glm::vec2 glyphOffset = transform.worldPosition;
 		glm::mat4 rotMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(transform.worldRotation), glm::vec3(0.0f, 0.0f, 1.0f));
 		glm::vec2 advanceDirection = transform.worldRotation == 0 ? glm::vec2(transform.scale.x, 0.0f) : glm::vec2(rotMatrix * glm::vec4(transform.scale.x, 0.0f, 0.0f, 1.0f));
@@ -3016,7 +2842,7 @@ void RenderSystem::update()
 
 			glyphOffset += float(glyph.advance >> 6) * advanceDirection;
 		}
-	}
+	});
 
 	vkCmdEndRenderPass(mCommandBuffer);
 	vkEndCommandBuffer(mCommandBuffer);
@@ -2,6 +2,8 @@
 #include "Texture.h"
 #include "Camera.h"
 #include "WindowManager.h"
+#include "View.h"
+#include "EntitySet.h"
 
 #define VSYNC true
 
@@ -129,6 +131,13 @@ struct DirectionalLightCreateInfo
 	operator DirectionalLight() const;
 };
 
+// Only the colour persists, the uniform buffer is created once the light is added
+template <>
+struct Reflection<DirectionalLight>
+{
+	static constexpr FieldInfo fields[] = { REFLECT_FIELD(DirectionalLight, colour) };
+};
+
 struct Sprite
 {
 	unsigned int width;
@@ -209,6 +218,7 @@ private:
 	friend class FontManager;
 
 	WindowManager& mWindowManager = WindowManager::instance();
+	const TransformSystem& mTransformSystem = TransformSystem::instance();
 	
 	ComponentManager<Camera>& mCameraManager = ComponentManager<Camera>::instance();
 	ComponentManager<Transform>& mTransformManager = ComponentManager<Transform>::instance();
@@ -220,42 +230,23 @@ private:
 	ComponentManager<UIButton>& mUIButtonManager = ComponentManager<UIButton>::instance();
 
 	// Callbacks called externally to ensure the render system is up to date
-	const ComponentAddedCallback mTransformAddedCallback = std::bind(&RenderSystem::transformAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mTransformRemovedCallback = std::bind(&RenderSystem::transformRemoved, this, std::placeholders::_1);
-	const ComponentAddedCallback mMeshAddedCallback = std::bind(&RenderSystem::meshAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mMeshRemovedCallback = std::bind(&RenderSystem::meshRemoved, this, std::placeholders::_1);
-	const ComponentAddedCallback mDirectionalLightAddedCallback = std::bind(&RenderSystem::directionalLightAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mDirectionalLightRemovedCallback = std::bind(&RenderSystem::directionalLightRemoved, this, std::placeholders::_1);
-	const ComponentAddedCallback mTransform2DAddedCallback = std::bind(&RenderSystem::transform2DAdded, this, std::placeholders::_1);
-	const ComponentAddedCallback mTransform2DRemovedCallback = std::bind(&RenderSystem::transform2DRemoved, this, std::placeholders::_1);
-	const ComponentAddedCallback mSpriteAddedCallback = std::bind(&RenderSystem::spriteAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mSpriteRemovedCallback = std::bind(&RenderSystem::spriteRemoved, this, std::placeholders::_1);
-	const ComponentAddedCallback mUITextAddedCallback = std::bind(&RenderSystem::UITextAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mUITextRemovedCallback = std::bind(&RenderSystem::UITextRemoved, this, std::placeholders::_1);
-	const ComponentAddedCallback mUIButtonAddedCallback = std::bind(&RenderSystem::UIButtonAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mUIButtonRemovedCallback = std::bind(&RenderSystem::UIButtonRemoved, this, std::placeholders::_1);
-
-	const TransformChangedCallback mMeshTransformChangedCallback = std::bind(&RenderSystem::meshTransformChanged, this, std::placeholders::_1);
-	const TransformChangedCallback mDirectionalLightTransformChangedCallback = std::bind(&RenderSystem::directionalLightTransformChanged, this, std::placeholders::_1);
 	const std::function<void(const Camera&)> mProjectionChangedCallback = std::bind(&RenderSystem::cameraProjectionChanged, this, std::placeholders::_1);
 	const std::function<void(const Transform&, const Camera&)> mViewChangedCallback = std::bind(&RenderSystem::cameraViewChanged, this, std::placeholders::_1, std::placeholders::_2);
 
 	const MouseButtonCallback mLMBPressedCallback = std::bind(&RenderSystem::LMBPressed, this);
 
-	// Compositions of entities that are included in the render system
-	Composition mMeshComposition;
-	Composition mDirectionalLightComposition;
+	// Views iterated each frame to record draw commands
+	View<const Mesh, const Transform> mMeshView;
+	View<const Sprite, const Transform2D> mSpriteView;
+	View<const UIText, const Transform2D> mUITextView;
+	View<UIButton, const Transform2D> mUIButtonView;
 
-	Composition mSpriteComposition;
-	Composition mUITextComposition;
-	Composition mUIButtonComposition;
-
-	// Dynamic arrays containing entities included in the render system
-	std::vector<EntityID> mMeshIDs;
-	std::vector<EntityID> mDirectionalLightIDs;
-	std::vector<EntityID> mSpriteIDs;
-	std::vector<EntityID> mUITextIDs;
-	std::vector<EntityID> mUIButtonIDs;
+	// Sets containing entities included in the render system, resources of each entity are created once it is added and destroyed before it is removed
+	SystemEntitySet<Transform, Mesh> mMeshIDs = { std::bind(&RenderSystem::addMesh, this, std::placeholders::_1), std::bind(&RenderSystem::removeMesh, this, std::placeholders::_1) };
+	SystemEntitySet<Transform, DirectionalLight> mDirectionalLightIDs = { std::bind(&RenderSystem::addDirectionalLight, this, std::placeholders::_1), std::bind(&RenderSystem::removeDirectionalLight, this, std::placeholders::_1) };
+	SystemEntitySet<Transform2D, Sprite> mSpriteIDs = { std::bind(&RenderSystem::addSprite, this, std::placeholders::_1), std::bind(&RenderSystem::removeSprite, this, std::placeholders::_1) };
+	SystemEntitySet<Transform2D, UIText> mUITextIDs;
+	SystemEntitySet<Transform2D, UIButton> mUIButtonIDs = { std::bind(&RenderSystem::addUIButton, this, std::placeholders::_1), std::bind(&RenderSystem::removeUIButton, this, std::placeholders::_1) };
 
 	#pragma region Vulkan resources
 	VkInstance mVkInstance = VK_NULL_HANDLE;
@@ -399,16 +390,16 @@ public:
 private:
 	void allocateMeshBuffers(Mesh& mesh);
 	void addMesh(const Entity& entity);
-	void removeMesh(const std::vector<EntityID>::iterator& IDIterator);
+	void removeMesh(const Entity& entity);
 
 	void addDirectionalLight(const Entity& entity);
-	void removeDirectionalLight(const std::vector<EntityID>::iterator& IDIterator);
+	void removeDirectionalLight(const Entity& entity);
 
 	void addSprite(const Entity& entity);
-	void removeSprite(const std::vector<EntityID>::iterator& IDIterator);
+	void removeSprite(const Entity& entity);
 
 	void addUIButton(const Entity& entity);
-	void removeUIButton(const std::vector<EntityID>::iterator& IDIterator);
+	void removeUIButton(const Entity& entity);
 
 public:
 	static RenderSystem& instance();
@@ -417,24 +408,11 @@ public:
 	~RenderSystem();
 
 	// Callback subroutines. Should not be used outside of their internal use
-	void transformAdded(const Entity& entity);
-	void transformRemoved(const Entity& entity);
-	void meshAdded(const Entity& entity);
-	void meshRemoved(const Entity& entity);
-	void directionalLightAdded(const Entity& entity);
-	void directionalLightRemoved(const Entity& entity);
-
-	void transform2DAdded(const Entity& entity);
-	void transform2DRemoved(const Entity& entity);
-	void spriteAdded(const Entity& entity);
-	void spriteRemoved(const Entity& entity);
-	void UITextAdded(const Entity& entity);
-	void UITextRemoved(const Entity& entity);
-	void UIButtonAdded(const Entity& entity);
-	void UIButtonRemoved(const Entity& entity);
-
-	void meshTransformChanged(Transform& transform) const;
-	void directionalLightTransformChanged(Transform& transform) const;
+	/*
+	Uploads the model and normal matrices of meshes, and the directions of directional lights, whose transforms have changed in a single submission.
+	\param changes: Changed transforms, such as those of the last transform update.
+	*/
+	void uploadTransforms(const std::vector<TransformChange>& changes) const;
 
 	void directionalLightChanged(const DirectionalLight& directionalLight);
 
@@ -479,9 +457,9 @@ std::vector<T*> getComponentsInHierarchy3D(const Entity& entity)
 		components.push_back(&entity.getComponent<T>());
 
 	Transform& transform = entity.getComponent<Transform>();
-	for (unsigned int i = 0; i < transform.childrenIDs.length; i++)
+	for (const EntityID& childID : transform.children())
 	{
-		std::vector<T*> childComponents = getComponentsInHierarchy3D<T>(Entity(transform.childrenIDs[i]));
+		std::vector<T*> childComponents = getComponentsInHierarchy3D<T>(Entity(childID));
 		components.insert(components.end(), childComponents.begin(), childComponents.end());
 	}
 
@@ -501,9 +479,9 @@ std::vector<T*> getComponentsInHierarchy2D(const Entity& entity)
 		components.push_back(&entity.getComponent<T>());
 
 	Transform2D& transform = entity.getComponent<Transform2D>();
-	for (unsigned int i = 0; i < transform.childrenIDs.length; i++)
+	for (const EntityID& childID : transform.children())
 	{
-		std::vector<T*> childComponents = getComponentsInHierarchy2D<T>(Entity(transform.childrenIDs[i]));
+		std::vector<T*> childComponents = getComponentsInHierarchy2D<T>(Entity(childID));
 		components.insert(components.end(), childComponents.begin(), childComponents.end());
 	}
 
@@ -0,0 +1,39 @@
+#include "NamePool.h"
+#include <climits>
+
+NamePool::NamePool()
+{
+	mStrings.emplace_back();
+	mHandles.insert({ mStrings.back(), 0 });
+}
+
+NamePool& NamePool::instance()
+{
+	static NamePool instance;
+	return instance;
+}
+
+NameHandle NamePool::intern(const std::string_view& string)
+{
+	std::unordered_map<std::string_view, NameHandle>::const_iterator it = mHandles.find(string);
+	if (it != mHandles.end())
+		return it->second;
+
+	assert(("[ERROR] Exceeded maximum number of interned names", mStrings.size() < UINT_MAX));
+	NameHandle handle = mStrings.size();
+	mStrings.emplace_back(string);
+	mHandles.insert({ mStrings.back(), handle });
+	return handle;
+}
+
+NameHandle NamePool::find(const std::string_view& string) const
+{
+	std::unordered_map<std::string_view, NameHandle>::const_iterator it = mHandles.find(string);
+	return it != mHandles.end() ? it->second : 0;
+}
+
+const std::string& NamePool::string(const NameHandle& handle) const
+{
+	assert(("[ERROR] Invalid name handle", handle < mStrings.size()));
+	return mStrings[handle];
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Vulkan.h"
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+typedef unsigned int NameHandle; // Handle to an interned string. 0 refers to the empty string
+
+/*
+Pool of interned strings. Each distinct string is stored once and identified by a 32 bit handle which remains valid for the lifetime of the program,
+so names shared by many entities cost a single string and may be compared and hashed as integers.
+*/
+class NamePool
+{
+private:
+	std::deque<std::string> mStrings; // Interned strings indexed by handle. A deque never moves its elements so the map's keys remain valid
+	std::unordered_map<std::string_view, NameHandle> mHandles; // Maps interned strings to their handles
+
+	NamePool();
+
+public:
+	static NamePool& instance();
+
+	NamePool(const NamePool& copy) = delete;
+
+	/*
+	Gets the handle of a string, interning the string if it has not been already.
+	\param string: String to intern.
+	\return The string's handle.
+	*/
+	NameHandle intern(const std::string_view& string);
+
+	/*
+	Gets the handle of a string without interning it.
+	\param string: String to search for.
+	\return The string's handle, or 0 if the string has not been interned.
+	*/
+	NameHandle find(const std::string_view& string) const;
+
+	/*
+	\param handle: Handle returned by intern.
+	\return The interned string.
+	*/
+	const std::string& string(const NameHandle& handle) const;
+};
@@ -1,4 +1,5 @@
 #include "Physics.h"
+#include "Scheduler.h"
 #include "pvd\PxPvd.h"
 
 void RigidBody::applyForce(const glm::vec3& force)
@@ -10,6 +11,11 @@ void RigidBody::applyForce(const glm::vec3& force)
 void RigidBody::setTransform(const glm::vec3& position, const glm::quat& rotation)
 {
 	pxRigidBody->setGlobalPose(physx::PxTransform(physx::PxVec3(position.x, position.y, position.z), physx::PxQuat(rotation.x, rotation.y, rotation.z, rotation.w)));
+
+	// Teleport rather than interpolate from the previous pose
+	previousPosition = currentPosition = position;
+	previousRotation = currentRotation = rotation;
+
 	Transform& transform = Entity(entityID).getComponent<Transform>();
 	transform.position = position;
 	transform.rotation = rotation;
@@ -72,7 +78,7 @@ void deserialize(const std::vector<char>& vecData, RigidBody& write)
 	static PhysicsSystem& physicsSystem = PhysicsSystem::instance();
 
 	const Composition& composition = Entity::getCompositionFromID(write.entityID);
-	assert(((composition & physicsSystem.mRigidBodyComposition) == physicsSystem.mRigidBodyComposition, "[ERROR] Attempting to deserialize a rigid body attached to an entity which does not possess all the required components"));
+	assert((composition.contains(physicsSystem.mRigidBodyComposition), "[ERROR] Attempting to deserialize a rigid body attached to an entity which does not possess all the required components"));
 	assert((write.type == UNDEFINED, "[ERROR] Attempting to deserialize a rigid body which has already been initialized"));
 
 	void* memory = malloc(vecData.size() + PX_SERIAL_FILE_ALIGN);
@@ -91,11 +97,14 @@ void deserialize(const std::vector<char>& vecData, RigidBody& write)
 
 	write.pxRigidBody->userData = new unsigned int(write.entityID);
 
+	const physx::PxTransform pxTransform = write.pxRigidBody->getGlobalPose();
+	write.previousPosition = write.currentPosition = glm::vec3(pxTransform.p.x, pxTransform.p.y, pxTransform.p.z);
+	write.previousRotation = write.currentRotation = glm::quat(pxTransform.q.w, pxTransform.q.x, pxTransform.q.y, pxTransform.q.z);
+
 	if (write.pxRigidBody->getConcreteType() == physx::PxConcreteType::eRIGID_STATIC)
 	{
 		write.type = STATIC;
-		physicsSystem.mTransformManager.getComponent(write.entityID).subscribeChangedEvent(&physicsSystem.mStaticTransformChangedCallback);
-		physicsSystem.mStaticEntityIDs.push_back(write.entityID);
+		physicsSystem.mStaticEntityIDs.insert(write.entityID);
 	}
 	else
 	{
@@ -103,25 +112,22 @@ void deserialize(const std::vector<char>& vecData, RigidBody& write)
 			write.type = KINEMATIC;
 		else
 			write.type = DYNAMIC;
-		physicsSystem.mDynamicEntityIDs.push_back(write.entityID);
+		physicsSystem.mDynamicEntityIDs.insert(write.entityID);
 	}
 }
 
 PhysicsSystem::PhysicsSystem()
 {
-	mTransformManager.subscribeAddedEvent(&mRigidBodyComponentAddedCallback);
+	mTransformManager.subscribeBatchAddedEvent(&mRigidBodyComponentsAddedCallback);
 	mTransformManager.subscribeRemovedEvent(&mRigidBodyComponentRemovedCallback);
-	mTransformManager.subscribeAddedEvent(&mControllerComponentAddedCallback);
-	mTransformManager.subscribeRemovedEvent(&mControllerComponentRemovedCallback);
 
-	mRigidBodyManager.subscribeAddedEvent(&mRigidBodyComponentAddedCallback);
+	mRigidBodyManager.subscribeBatchAddedEvent(&mRigidBodyComponentsAddedCallback);
 	mRigidBodyManager.subscribeRemovedEvent(&mRigidBodyComponentRemovedCallback);
 
-	mCharacterControllerManager.subscribeAddedEvent(&mControllerComponentAddedCallback);
-	mCharacterControllerManager.subscribeRemovedEvent(&mControllerComponentRemovedCallback);
+	mInactiveManager.subscribeBatchAddedEvent(&mEntitiesDeactivatedCallback);
+	mInactiveManager.subscribeBatchRemovedEvent(&mEntitiesActivatedCallback);
 
 	mRigidBodyComposition = mTransformManager.bit | mRigidBodyManager.bit;
-	mCharacterControllerComposition = mTransformManager.bit | mCharacterControllerManager.bit;
 
 	// Input
 	mLastCursorPosition = mWindowManager.cursorPosition();
@@ -158,8 +164,9 @@ PhysicsSystem::PhysicsSystem()
 	// Create scene
 	physx::PxSceneDesc sceneDesc(scale);
 	sceneDesc.gravity = physx::PxVec3(0.0f, -9.81f, 0.0f);
-	sceneDesc.cpuDispatcher = cpuDispatcher = physx::PxDefaultCpuDispatcherCreate(PX_THREADS);
+	sceneDesc.cpuDispatcher = &cpuDispatcher;
 	sceneDesc.filterShader = physx::PxDefaultSimulationFilterShader;
+	sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS; // Report which actors moved during each step so only their poses are read
 	scene = physics->createScene(sceneDesc);
 
 	#ifdef NDEBUG
@@ -176,6 +183,26 @@ PhysicsSystem::PhysicsSystem()
 	serializationRegistry = physx::PxSerialization::createSerializationRegistry(*physics);
 }
 
+void JobDispatcher::submitTask(physx::PxBaseTask& task)
+{
+	// Tasks are submitted from the thread calling simulate or from other tasks, so may be scheduled from any thread
+	mJobSystem.schedule([&task]()
+	{
+		task.run();
+		task.release(); // Submits the tasks which were waiting on this one
+	}, &mCounter);
+}
+
+physx::PxU32 JobDispatcher::getWorkerCount() const
+{
+	return mJobSystem.nThreads();
+}
+
+void JobDispatcher::wait()
+{
+	mJobSystem.wait(mCounter);
+}
+
 PhysicsSystem& PhysicsSystem::instance()
 {
 	static PhysicsSystem instance;
@@ -184,16 +211,14 @@ PhysicsSystem& PhysicsSystem::instance()
 
 PhysicsSystem::~PhysicsSystem()
 {
-	mTransformManager.unsubscribeAddedEvent(&mRigidBodyComponentAddedCallback);
+	mTransformManager.unsubscribeBatchAddedEvent(&mRigidBodyComponentsAddedCallback);
 	mTransformManager.unsubscribeRemovedEvent(&mRigidBodyComponentRemovedCallback);
-	mTransformManager.unsubscribeAddedEvent(&mControllerComponentAddedCallback);
-	mTransformManager.unsubscribeRemovedEvent(&mControllerComponentRemovedCallback);
 
-	mRigidBodyManager.unsubscribeAddedEvent(&mRigidBodyComponentAddedCallback);
+	mRigidBodyManager.unsubscribeBatchAddedEvent(&mRigidBodyComponentsAddedCallback);
 	mRigidBodyManager.unsubscribeRemovedEvent(&mRigidBodyComponentRemovedCallback);
 
-	mCharacterControllerManager.unsubscribeAddedEvent(&mControllerComponentAddedCallback);
-	mCharacterControllerManager.unsubscribeRemovedEvent(&mControllerComponentRemovedCallback);
+	mInactiveManager.unsubscribeBatchAddedEvent(&mEntitiesDeactivatedCallback);
+	mInactiveManager.unsubscribeBatchRemovedEvent(&mEntitiesActivatedCallback);
 
 	for (physx::PxCollection* collection : mCollections)
 	{
@@ -238,196 +263,343 @@ physx::PxMaterial* PhysicsSystem::getMaterial(const PxMaterialInfo& materialInfo
 	return material;
 }
 
-void PhysicsSystem::componentAdded(const Entity& entity)
+void PhysicsSystem::componentsAdded(const EntitySpan& entityIDs)
 {
-	if ((entity.composition() & mRigidBodyComposition) == mRigidBodyComposition)
+	// Actors are created individually but added to the scene in one batch
+	std::vector<physx::PxActor*> actors;
+	for (const EntityID& entityID : entityIDs)
 	{
-		RigidBody& rigidBody = entity.getComponent<RigidBody>();
-		rigidBody.entityID = entity.ID();
-
-		if (rigidBody.nVertices > 0)
+		Entity entity(entityID);
+		if (entity.composition().contains(mRigidBodyComposition))
 		{
-			Transform& transform = entity.getComponent<Transform>();
-			const physx::PxTransform pxTransform(physx::PxVec3{ transform.position.x, transform.position.y, transform.position.z }, physx::PxQuat{ transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w });
+			RigidBody& rigidBody = entity.getComponent<RigidBody>();
+			rigidBody.entityID = entity.ID();
 
-			physx::PxGeometry* geometry;
+			const Transform& transform = mTransformManager.readComponent(entityID);
+			rigidBody.previousPosition = rigidBody.currentPosition = transform.position;
+			rigidBody.previousRotation = rigidBody.currentRotation = transform.rotation;
 
-			if (rigidBody.type == STATIC && rigidBody.nIndices > 0)
+			if (rigidBody.nVertices > 0)
 			{
-				physx::PxTriangleMeshDesc meshDesc;
-				meshDesc.points.count = rigidBody.nVertices;
-				meshDesc.points.stride = sizeof(glm::vec3);
-				meshDesc.points.data = rigidBody.vertices;
-				meshDesc.triangles.count = rigidBody.nIndices;
-				meshDesc.triangles.stride = 3 * sizeof(unsigned int);
-				meshDesc.triangles.data = rigidBody.indices;
-
-				assert((meshDesc.isValid(), "[ERROR PHYSX] Invalid mesh descriptor"));
-
-				physx::PxDefaultMemoryOutputStream writeBuffer;
-				physx::PxTriangleMeshCookingResult::Enum result;
-				bool status = cooking->cookTriangleMesh(meshDesc, writeBuffer, &result);
-				assert((status, "[ERROR PHYSX] Convex mesh cook failed"));
-				assert((!result, "[ERROR PHYSX] Convex mesh cook failed"));
-
-				physx::PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
-				rigidBody.pxMesh = physics->createTriangleMesh(readBuffer);
-
-				geometry = new physx::PxTriangleMeshGeometry((physx::PxTriangleMesh*)rigidBody.pxMesh, physx::PxMeshScale({ transform.scale.x, transform.scale.y, transform.scale.z }));
-			}
-			else
-			{
-				physx::PxConvexMeshDesc meshDesc;
-				meshDesc.points.count = rigidBody.nVertices;
-				meshDesc.points.stride = sizeof(physx::PxVec3);
-				meshDesc.points.data = rigidBody.vertices;
-				meshDesc.vertexLimit = rigidBody.nComputeVertices;
-				meshDesc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX;
+				const physx::PxTransform pxTransform(physx::PxVec3{ transform.position.x, transform.position.y, transform.position.z }, physx::PxQuat{ transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w });
 
-				assert((meshDesc.isValid(), "[ERROR PHYSX] Invalid mesh descriptor"));
+				physx::PxGeometry* geometry;
 
-				physx::PxDefaultMemoryOutputStream writeBuffer;
-				physx::PxConvexMeshCookingResult::Enum result;
-				bool status = cooking->cookConvexMesh(meshDesc, writeBuffer, &result);
-				assert((status, "[ERROR PHYSX] Convex mesh cook failed"));
-				assert((!result, "[ERROR PHYSX] Convex mesh cook failed"));
+				if (rigidBody.type == STATIC && rigidBody.nIndices > 0)
+				{
+					physx::PxTriangleMeshDesc meshDesc;
+					meshDesc.points.count = rigidBody.nVertices;
+					meshDesc.points.stride = sizeof(glm::vec3);
+					meshDesc.points.data = rigidBody.vertices;
+					meshDesc.triangles.count = rigidBody.nIndices;
+					meshDesc.triangles.stride = 3 * sizeof(unsigned int);
+					meshDesc.triangles.data = rigidBody.indices;
+
+					assert((meshDesc.isValid(), "[ERROR PHYSX] Invalid mesh descriptor"));
+
+					physx::PxDefaultMemoryOutputStream writeBuffer;
+					physx::PxTriangleMeshCookingResult::Enum result;
+					bool status = cooking->cookTriangleMesh(meshDesc, writeBuffer, &result);
+					assert((status, "[ERROR PHYSX] Convex mesh cook failed"));
+					assert((!result, "[ERROR PHYSX] Convex mesh cook failed"));
+
+					physx::PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
+					rigidBody.pxMesh = physics->createTriangleMesh(readBuffer);
+
+					geometry = new physx::PxTriangleMeshGeometry((physx::PxTriangleMesh*)rigidBody.pxMesh, physx::PxMeshScale({ transform.scale.x, transform.scale.y, transform.scale.z }));
+				}
+				else
+				{
+					physx::PxConvexMeshDesc meshDesc;
+					meshDesc.points.count = rigidBody.nVertices;
+					meshDesc.points.stride = sizeof(physx::PxVec3);
+					meshDesc.points.data = rigidBody.vertices;
+					meshDesc.vertexLimit = rigidBody.nComputeVertices;
+					meshDesc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX;
 
-				physx::PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
-				rigidBody.pxMesh = physics->createConvexMesh(readBuffer);
+					assert((meshDesc.isValid(), "[ERROR PHYSX] Invalid mesh descriptor"));
 
-				geometry = new physx::PxConvexMeshGeometry((physx::PxConvexMesh*)rigidBody.pxMesh, physx::PxMeshScale({ transform.scale.x, transform.scale.y, transform.scale.z }));
-			}
+					physx::PxDefaultMemoryOutputStream writeBuffer;
+					physx::PxConvexMeshCookingResult::Enum result;
+					bool status = cooking->cookConvexMesh(meshDesc, writeBuffer, &result);
+					assert((status, "[ERROR PHYSX] Convex mesh cook failed"));
+					assert((!result, "[ERROR PHYSX] Convex mesh cook failed"));
 
-			if (rigidBody.type == STATIC)
-			{
-				rigidBody.pxRigidBody = physx::PxCreateStatic(*physics, pxTransform, *geometry, *getMaterial(rigidBody.material));
-				rigidBody.pxRigidBody->userData = new unsigned int(entity.ID());
-				assert((rigidBody.pxRigidBody, "[ERROR PHYSX] Rigid body creation failed"));
-				entity.getComponent<Transform>().subscribeChangedEvent(&mStaticTransformChangedCallback);
-				mStaticEntityIDs.push_back(entity.ID());
-			}
-			else
-			{
-				rigidBody.pxRigidBody = physx::PxCreateDynamic(*physics, pxTransform, *geometry, *getMaterial(rigidBody.material), rigidBody.density);
-				rigidBody.pxRigidBody->userData = new unsigned int(entity.ID());
-				assert((rigidBody.pxRigidBody, "[ERROR PHYSX] Rigid body creation failed"));
-				if (rigidBody.type == KINEMATIC)
-					((physx::PxRigidDynamic*)rigidBody.pxRigidBody)->setRigidBodyFlag(physx::PxRigidBodyFlag::eKINEMATIC, true);
-				else
+					physx::PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
+					rigidBody.pxMesh = physics->createConvexMesh(readBuffer);
+
+					geometry = new physx::PxConvexMeshGeometry((physx::PxConvexMesh*)rigidBody.pxMesh, physx::PxMeshScale({ transform.scale.x, transform.scale.y, transform.scale.z }));
+				}
+
+				if (rigidBody.type == STATIC)
 				{
-					((physx::PxRigidDynamic*)rigidBody.pxRigidBody)->setSleepThreshold(0.1f);
-					mDynamicEntityIDs.push_back(entity.ID());
+					rigidBody.pxRigidBody = physx::PxCreateStatic(*physics, pxTransform, *geometry, *getMaterial(rigidBody.material));
+					rigidBody.pxRigidBody->userData = new unsigned int(entity.ID());
+					assert((rigidBody.pxRigidBody, "[ERROR PHYSX] Rigid body creation failed"));
+					mStaticEntityIDs.insert(entity.ID());
 				}
+				else
+				{
+					rigidBody.pxRigidBody = physx::PxCreateDynamic(*physics, pxTransform, *geometry, *getMaterial(rigidBody.material), rigidBody.density);
+					rigidBody.pxRigidBody->userData = new unsigned int(entity.ID());
+					assert((rigidBody.pxRigidBody, "[ERROR PHYSX] Rigid body creation failed"));
+					if (rigidBody.type == KINEMATIC)
+						((physx::PxRigidDynamic*)rigidBody.pxRigidBody)->setRigidBodyFlag(physx::PxRigidBodyFlag::eKINEMATIC, true);
+					else
+					{
+						((physx::PxRigidDynamic*)rigidBody.pxRigidBody)->setSleepThreshold(0.1f);
+						mDynamicEntityIDs.insert(entity.ID());
+					}
 				
-			}
-			scene->addActor(*rigidBody.pxRigidBody);
+				}
+				if (entity.active()) // Inactive entities' actors are added once reactivated
+					actors.push_back(rigidBody.pxRigidBody);
 
-			delete geometry;
-		}
-		else
-		{
-			rigidBody.type = UNDEFINED;
-			rigidBody.pxMesh = nullptr;
-			rigidBody.pxRigidBody = nullptr;
+				delete geometry;
+			}
+			else
+			{
+				rigidBody.type = UNDEFINED;
+				rigidBody.pxMesh = nullptr;
+				rigidBody.pxRigidBody = nullptr;
+			}
 		}
 	}
+
+	if (!actors.empty())
+		scene->addActors(actors.data(), actors.size());
 }
 
 void PhysicsSystem::componentRemoved(const Entity& entity)
 {
-	std::vector<EntityID>::iterator staticIDIterator = std::find(mStaticEntityIDs.begin(), mStaticEntityIDs.end(), entity.ID());
-	std::vector<EntityID>::iterator dynamicIDIterator = std::find(mDynamicEntityIDs.begin(), mDynamicEntityIDs.end(), entity.ID());
-
-	if (staticIDIterator != mStaticEntityIDs.end())
+	if (mStaticEntityIDs.erase(entity.ID()) || mDynamicEntityIDs.erase(entity.ID()))
 	{
 		RigidBody& rigidBody = entity.getComponent<RigidBody>();
 		rigidBody.pxMesh->release();
 		delete rigidBody.pxRigidBody->userData;
 		rigidBody.pxRigidBody->release();
+	}
+}
 
-		Transform& transform = entity.getComponent<Transform>();
-		if (transform.changedCallbacks.data)
-			transform.unsubscribeChangedEvent(&mStaticTransformChangedCallback);
+void PhysicsSystem::entitiesDeactivated(const EntitySpan& entityIDs)
+{
+	for (const EntityID& entityID : entityIDs)
+	{
+		if (!mRigidBodyManager.hasComponent(entityID))
+			continue;
 
-		mStaticEntityIDs.erase(staticIDIterator);
+		const RigidBody& rigidBody = mRigidBodyManager.readComponent(entityID);
+		if (rigidBody.pxRigidBody && rigidBody.pxRigidBody->getScene())
+			scene->removeActor(*rigidBody.pxRigidBody);
 	}
-	else if (dynamicIDIterator != mDynamicEntityIDs.end())
+}
+
+void PhysicsSystem::entitiesActivated(const EntitySpan& entityIDs)
+{
+	// Actors are returned to the scene in one batch
+	std::vector<physx::PxActor*> actors;
+	std::vector<physx::PxRigidDynamic*> dynamicActors;
+	for (const EntityID& entityID : entityIDs)
 	{
-		RigidBody& rigidBody = entity.getComponent<RigidBody>();
-		rigidBody.pxMesh->release();
-		delete rigidBody.pxRigidBody->userData;
-		rigidBody.pxRigidBody->release();
+		if (!Entity::getCompositionFromID(entityID).contains(mRigidBodyComposition))
+			continue;
+
+		RigidBody& rigidBody = mRigidBodyManager.getComponent(entityID);
+		if (!rigidBody.pxRigidBody || rigidBody.pxRigidBody->getScene())
+			continue;
+
+		const Transform& transform = mTransformManager.readComponent(entityID);
+		rigidBody.previousPosition = rigidBody.currentPosition = transform.position;
+		rigidBody.previousRotation = rigidBody.currentRotation = transform.rotation;
+		rigidBody.pxRigidBody->setGlobalPose(physx::PxTransform(physx::PxVec3{ transform.position.x, transform.position.y, transform.position.z }, physx::PxQuat{ transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w }));
+		actors.push_back(rigidBody.pxRigidBody);
+		if (rigidBody.type == DYNAMIC)
+			dynamicActors.push_back((physx::PxRigidDynamic*)rigidBody.pxRigidBody);
+	}
 
-		mDynamicEntityIDs.erase(dynamicIDIterator);
+	if (!actors.empty())
+		scene->addActors(actors.data(), actors.size());
+
+	// Velocities may only be set once actors are in a scene
+	for (physx::PxRigidDynamic* dynamicActor : dynamicActors)
+	{
+		dynamicActor->setLinearVelocity(physx::PxVec3(0.0f));
+		dynamicActor->setAngularVelocity(physx::PxVec3(0.0f));
 	}
 }
 
 void PhysicsSystem::controllerComponentAdded(const Entity& entity)
 {
-	if ((entity.composition() & mCharacterControllerComposition) == mCharacterControllerComposition)
-	{
-		Transform& transform = entity.getComponent<Transform>();
-		CharacterController& characterController = entity.getComponent<CharacterController>();
-
-		physx::PxCapsuleControllerDesc controllerDesc;
-
-		controllerDesc.position = physx::PxExtendedVec3{ transform.position.x, transform.position.y, transform.position.z };
-		controllerDesc.upDirection = { 0, 1, 0 };
-		controllerDesc.slopeLimit = characterController.maxSlope;
-		controllerDesc.invisibleWallHeight = characterController.invisibleWallHeight;
-		controllerDesc.maxJumpHeight = characterController.maxJumpHeight;
-		controllerDesc.contactOffset = characterController.contactOffset;
-		controllerDesc.stepOffset = characterController.maxStepHeight;
-		controllerDesc.volumeGrowth = characterController.cacheVolumeFactor;
-		controllerDesc.reportCallback = nullptr;
-		controllerDesc.behaviorCallback = nullptr;
-		controllerDesc.nonWalkableMode = characterController.slide ? physx::PxControllerNonWalkableMode::ePREVENT_CLIMBING_AND_FORCE_SLIDING : physx::PxControllerNonWalkableMode::ePREVENT_CLIMBING;
-		controllerDesc.material = getMaterial(characterController.material);
-
-		controllerDesc.radius = characterController.radius;
-		controllerDesc.height = characterController.height;
-		controllerDesc.climbingMode = physx::PxCapsuleClimbingMode::eEASY;
-
-		characterController.pxController = controllerManager->createController(controllerDesc);
-
-		physx::PxRigidDynamic* rigidDynamic = characterController.pxController->getActor();
-
-		unsigned int bufferLength = rigidDynamic->getNbShapes();
-		physx::PxShape** shapes = new physx::PxShape*[bufferLength];
-		rigidDynamic->getShapes(shapes, bufferLength * sizeof(physx::PxShape*));
-		shapes[0]->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);
-		shapes[0]->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, false);
-
-		mControllerEntityIDs.push_back(entity.ID());
-	}
+	Transform& transform = entity.getComponent<Transform>();
+	CharacterController& characterController = entity.getComponent<CharacterController>();
+
+	physx::PxCapsuleControllerDesc controllerDesc;
+
+	controllerDesc.position = physx::PxExtendedVec3{ transform.position.x, transform.position.y, transform.position.z };
+	controllerDesc.upDirection = { 0, 1, 0 };
+	controllerDesc.slopeLimit = characterController.maxSlope;
+	controllerDesc.invisibleWallHeight = characterController.invisibleWallHeight;
+	controllerDesc.maxJumpHeight = characterController.maxJumpHeight;
+	controllerDesc.contactOffset = characterController.contactOffset;
+	controllerDesc.stepOffset = characterController.maxStepHeight;
+	controllerDesc.volumeGrowth = characterController.cacheVolumeFactor;
+	controllerDesc.reportCallback = nullptr;
+	controllerDesc.behaviorCallback = nullptr;
+	controllerDesc.nonWalkableMode = characterController.slide ? physx::PxControllerNonWalkableMode::ePREVENT_CLIMBING_AND_FORCE_SLIDING : physx::PxControllerNonWalkableMode::ePREVENT_CLIMBING;
+	controllerDesc.material = getMaterial(characterController.material);
+
+	controllerDesc.radius = characterController.radius;
+	controllerDesc.height = characterController.height;
+	controllerDesc.climbingMode = physx::PxCapsuleClimbingMode::eEASY;
+
+	characterController.pxController = controllerManager->createController(controllerDesc);
+	characterController.previousPosition = characterController.currentPosition = transform.position;
+
+	physx::PxRigidDynamic* rigidDynamic = characterController.pxController->getActor();
+
+	unsigned int bufferLength = rigidDynamic->getNbShapes();
+	physx::PxShape** shapes = new physx::PxShape*[bufferLength];
+	rigidDynamic->getShapes(shapes, bufferLength * sizeof(physx::PxShape*));
+	shapes[0]->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);
+	shapes[0]->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, false);
 }
 
 void PhysicsSystem::controllerComponentRemoved(const Entity& entity)
 {
-	std::vector<EntityID>::iterator controllerIDIterator = std::find(mControllerEntityIDs.begin(), mControllerEntityIDs.end(), entity.ID());
-	if (controllerIDIterator != mControllerEntityIDs.end())
+	CharacterController& characterController = entity.getComponent<CharacterController>();
+	characterController.pxController->release();
+}
+
+void PhysicsSystem::simulateStep(const bool& jump)
+{
+	const float timestep = PHYSICS_TIMESTEP;
+
+	// Character controllers move kinematically so are moved before the scene is simulated
+	mControllerView.each([&](const EntityID& ID, CharacterController& controller, const Transform& transform)
 	{
-		CharacterController& characterController = entity.getComponent<CharacterController>();
-		characterController.pxController->release();
-		mControllerEntityIDs.erase(controllerIDIterator);
-	}
+		bool grounded = raycast(glm::vec3(controller.currentPosition.x, controller.currentPosition.y - 0.5 * controller.height - controller.radius, controller.currentPosition.z), glm::vec3(0.0f, -1.0f, 0.0f), 0.02f, UNDEFINED).hasBlock;
+		
+		if (grounded)
+		{
+			// Calculate global move velocity.
+			glm::vec3 xzVelocity(lerp(0.0, 1.0, rightDuration / CHARACTER_ACCELERATION_TIME), 0.0f, -lerp(0.0, 1.0, forwardDuration / CHARACTER_ACCELERATION_TIME));
+			xzVelocity = transform.rotation * xzVelocity;
+			float length = glm::length(xzVelocity);
+			if (length > 1.0f)
+				xzVelocity /= length;
+			xzVelocity *= controller.speed;
+
+			controller.velocity.x = xzVelocity.x;
+			controller.velocity.z = xzVelocity.z;
+
+			if (jump)
+				controller.velocity.y = controller.jumpSpeed * timestep;
+			else
+				controller.velocity.y = 0.0;
+		}
+		else
+			controller.velocity.y -= 9.8 * timestep;
+
+		glm::vec3 displacement = controller.velocity * timestep;
+		physx::PxControllerCollisionFlags flags = controller.pxController->move({ displacement.x, displacement.y, displacement.z }, 0.01f, timestep, 0);
+
+		physx::PxExtendedVec3 position = controller.pxController->getPosition();
+		if (flags & physx::PxControllerCollisionFlag::eCOLLISION_UP)
+		{
+			controller.pxController->setPosition(position + physx::PxExtendedVec3(0.0f, -0.05f, 0.0f));
+			controller.velocity.y = 0.0f;
+		}
+		
+		position = controller.pxController->getPosition();
+		controller.previousPosition = controller.currentPosition;
+		controller.currentPosition = glm::vec3(position.x, position.y, position.z);
+	});
+
+	mSimulateStart = std::chrono::high_resolution_clock::now();
+	scene->simulate(timestep);
+	mSimulating = true;
 }
 
-void PhysicsSystem::update(const double& deltaTime)
+void PhysicsSystem::fetchStep()
 {
-	scene->simulate(deltaTime);
+	// Help run the step's tasks rather than blocking, which would never finish without worker threads. The counter may reach zero between tasks so results are checked again
+	while (!scene->checkResults(false))
+		cpuDispatcher.wait();
 	scene->fetchResults(true);
+	mSimulating = false;
+
+	// Bodies which moved during the previous step start this one at rest, and their transforms are placed at their final pose unless they moved again
+	for (const EntityID& entityID : mMovingEntityIDs)
+	{
+		if (!mRigidBodyManager.hasComponent(entityID)) // Destroyed since it moved
+			continue;
 
-	// Rigid bodies
-	for (const EntityID& ID : mDynamicEntityIDs)
+		RigidBody& rigidBody = mRigidBodyManager.getComponent(entityID);
+		rigidBody.previousPosition = rigidBody.currentPosition;
+		rigidBody.previousRotation = rigidBody.currentRotation;
+	}
+	mSettledEntityIDs.insert(mSettledEntityIDs.end(), mMovingEntityIDs.begin(), mMovingEntityIDs.end());
+	mMovingEntityIDs.clear();
+
+	// Only actors which moved during the step are reported, so sleeping bodies cost nothing. Actors store their entity's ID so no lookup is needed
+	physx::PxU32 nActiveActors;
+	physx::PxActor** activeActors = scene->getActiveActors(nActiveActors);
+	for (physx::PxU32 i = 0; i < nActiveActors; i++)
 	{
-		Transform& transform = mTransformManager.getComponent(ID);
-		RigidBody& rigidBody = mRigidBodyManager.getComponent(ID);
+		if (!activeActors[i]->userData) // Character controllers' actors are synchronized separately
+			continue;
+
+		EntityID entityID = *(EntityID*)activeActors[i]->userData;
+		RigidBody& rigidBody = mRigidBodyManager.getComponent(entityID);
+		if (rigidBody.type != DYNAMIC) // Kinematic bodies are moved by their transforms
+			continue;
 
 		const physx::PxTransform pxTransform = rigidBody.pxRigidBody->getGlobalPose();
-		transform.position = glm::vec3(pxTransform.p.x, pxTransform.p.y, pxTransform.p.z);
-		transform.rotation = glm::quat(pxTransform.q.w, pxTransform.q.x, pxTransform.q.y, pxTransform.q.z);
+		rigidBody.currentPosition = glm::vec3(pxTransform.p.x, pxTransform.p.y, pxTransform.p.z);
+		rigidBody.currentRotation = glm::quat(pxTransform.q.w, pxTransform.q.x, pxTransform.q.y, pxTransform.q.z);
+		mMovingEntityIDs.push_back(entityID);
+	}
+}
+
+void PhysicsSystem::interpolateTransforms()
+{
+	// Settled bodies come first so bodies which settled and then moved again during the same update end up interpolated
+	for (const EntityID& entityID : mSettledEntityIDs)
+	{
+		if (!mRigidBodyManager.hasComponent(entityID))
+			continue;
+
+		const RigidBody& rigidBody = mRigidBodyManager.readComponent(entityID);
+		Transform& transform = mTransformManager.getComponent(entityID);
+		transform.position = rigidBody.currentPosition;
+		transform.rotation = rigidBody.currentRotation;
 	}
+	mSettledEntityIDs.clear();
+
+	for (const EntityID& entityID : mMovingEntityIDs)
+	{
+		if (!mRigidBodyManager.hasComponent(entityID))
+			continue;
+
+		const RigidBody& rigidBody = mRigidBodyManager.readComponent(entityID);
+		Transform& transform = mTransformManager.getComponent(entityID);
+		transform.position = glm::mix(rigidBody.previousPosition, rigidBody.currentPosition, mInterpolation);
+		transform.rotation = glm::slerp(rigidBody.previousRotation, rigidBody.currentRotation, mInterpolation);
+	}
+
+	mControllerPoseView.each([&](const EntityID& ID, const CharacterController& controller, const Transform& transform)
+	{
+		// Controllers at rest are left unchanged so their hierarchies are not propagated again
+		glm::vec3 position = glm::mix(controller.previousPosition, controller.currentPosition, mInterpolation);
+		if (position != transform.position)
+			mTransformManager.getComponent(ID).position = position;
+	});
+}
+
+void PhysicsSystem::beginStep(const double& deltaTime)
+{
+	assert(("[ERROR] Attempting to begin a physics step before the previous step has ended", !mSimulating));
+	updateStaticBodies();
 
 	// Character controllers
 	bool forwardDown = mWindowManager.keyDown(W);
@@ -460,56 +632,66 @@ void PhysicsSystem::update(const double& deltaTime)
 	glm::vec2 cursorDelta = cursorPosition - mLastCursorPosition;
 	mLastCursorPosition = cursorPosition;
 
-	// Input controls all CharacterControllers
-	for (const EntityID& ID : mControllerEntityIDs)
+	// Yaw character with cursor x axis. Input controls all CharacterControllers; their transforms are only marked as changed when the cursor moved
+	if (cursorDelta.x != 0.0f)
 	{
-		Transform& transform = mTransformManager.getComponent(ID);
-		CharacterController& controller = mCharacterControllerManager.getComponent(ID);
-
-		// Yaw character with cursor x axis
-		transform.rotate(-cursorDelta.x * 0.005f, glm::vec3(0.0f, 1.0f, 0.0f));
-
-		bool grounded = raycast(glm::vec3(transform.position.x, transform.position.y - 0.5 * controller.height - controller.radius, transform.position.z), glm::vec3(0.0f, -1.0f, 0.0f), 0.02f, UNDEFINED).hasBlock;
-		
-		if (grounded)
+		mControllerPoseView.each([&](const EntityID& ID, const CharacterController& controller, const Transform& transform)
 		{
-			// Calculate global move velocity.
-			glm::vec3 xzVelocity(lerp(0.0, 1.0, rightDuration / CHARACTER_ACCELERATION_TIME), 0.0f, -lerp(0.0, 1.0, forwardDuration / CHARACTER_ACCELERATION_TIME));
-			xzVelocity = transform.rotation * xzVelocity;
-			float length = glm::length(xzVelocity);
-			if (length > 1.0f)
-				xzVelocity /= length;
-			xzVelocity *= controller.speed;
+			mTransformManager.getComponent(ID).rotate(-cursorDelta.x * 0.005f, glm::vec3(0.0f, 1.0f, 0.0f));
+		});
+	}
 
-			controller.velocity.x = xzVelocity.x;
-			controller.velocity.z = xzVelocity.z;
+	// Simulate the whole steps which fit in the time passed. Time beyond PHYSICS_MAX_STEPS steps is dropped, slowing the simulation down during slow frames
+	mAccumulator = std::min(mAccumulator + deltaTime, PHYSICS_MAX_STEPS * PHYSICS_TIMESTEP);
+	while (mAccumulator >= PHYSICS_TIMESTEP)
+	{
+		// Each step starts from the results of the previous one, so only the last step is left simulating
+		if (mSimulating)
+			fetchStep();
+		simulateStep(spaceDown);
+		mAccumulator -= PHYSICS_TIMESTEP;
+	}
+	mInterpolation = float(mAccumulator / PHYSICS_TIMESTEP);
+}
 
-			if (spaceDown)
-				controller.velocity.y = controller.jumpSpeed * deltaTime;
-			else
-				controller.velocity.y = 0.0;
-		}
-		else
-			controller.velocity.y -= 9.8 * deltaTime;
+void PhysicsSystem::endStep()
+{
+	static Scheduler& scheduler = Scheduler::instance();
 
-		glm::vec3 displacement = controller.velocity * (float)deltaTime;
-		physx::PxControllerCollisionFlags flags = controller.pxController->move({ displacement.x, displacement.y, displacement.z }, 0.01f, deltaTime, 0);
+	if (mSimulating)
+	{
+		std::chrono::high_resolution_clock::time_point waitStart = std::chrono::high_resolution_clock::now();
+		fetchStep();
+		std::chrono::high_resolution_clock::time_point waitEnd = std::chrono::high_resolution_clock::now();
 
-		physx::PxExtendedVec3 position = controller.pxController->getPosition();
-		if (flags & physx::PxControllerCollisionFlag::eCOLLISION_UP)
-		{
-			controller.pxController->setPosition(position + physx::PxExtendedVec3(0.0f, -0.05f, 0.0f));
-			controller.velocity.y = 0.0f;
-		}
-		
-		position = controller.pxController->getPosition();
-		transform.position = glm::vec3(position.x, position.y, position.z);
+		// The simulation's tasks run across the job system's threads so the step as a whole is traced as external work
+		scheduler.addTrace("Physics simulation", mSimulateStart, waitEnd, UINT_MAX);
+		scheduler.addTrace("Physics wait", waitStart, waitEnd, JobSystem::currentThread());
 	}
+
+	interpolateTransforms();
+}
+
+float PhysicsSystem::interpolationFactor() const
+{
+	return mInterpolation;
 }
 
-void PhysicsSystem::staticTransformChanged(const Transform& transform) const
+void PhysicsSystem::updateStaticBodies() const
 {
-	mRigidBodyManager.getComponent(transform.entityID).pxRigidBody->setGlobalPose(physx::PxTransform(physx::PxVec3(transform.position.x, transform.position.y, transform.position.z), physx::PxQuat(transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w)));
+	for (const TransformChange& change : mTransformSystem.changes())
+	{
+		// A change of scale alone does not move the body
+		if (!(change.flags & (POSITION_CHANGED | ROTATION_CHANGED)) || !Entity::valid(change.entityID) || !Entity::getCompositionFromID(change.entityID).contains(mRigidBodyComposition))
+			continue;
+
+		const RigidBody& rigidBody = mRigidBodyManager.readComponent(change.entityID);
+		if (rigidBody.type != STATIC)
+			continue;
+
+		const Transform& transform = mTransformManager.readComponent(change.entityID);
+		rigidBody.pxRigidBody->setGlobalPose(physx::PxTransform(physx::PxVec3(transform.position.x, transform.position.y, transform.position.z), physx::PxQuat(transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w)));
+	}
 }
 
 physx::PxRaycastBuffer PhysicsSystem::raycast(const glm::vec3& origin, const glm::vec3& direction, const float& distance, const RigidBodyType& filter) const
@@ -3,14 +3,20 @@
 #include "Transform.h"
 #include "WindowManager.h"
 #include "Math.h"
+#include "View.h"
+#include "EntitySet.h"
+#include "JobSystem.h"
 #include "PxPhysicsAPI.h"
 #include "foundation/PxAllocatorCallback.h"
+#include <chrono>
 
 #define PX_RECORD_MEMORY_ALLOCATIONS true
-#define PX_THREADS 2
 
 #define CHARACTER_ACCELERATION_TIME 0.5
 
+#define PHYSICS_TIMESTEP (1.0 / 60.0) // Duration in seconds of each simulation step, independent of the frame rate
+#define PHYSICS_MAX_STEPS 4 // Maximum number of simulation steps per frame. Time beyond them is dropped so a slow frame is not followed by slower ones
+
 struct PxMaterialInfo
 {
 	float staticFriction;
@@ -57,6 +63,12 @@ struct RigidBody
 	physx::PxBase* pxMesh;
 	physx::PxRigidActor* pxRigidBody;
 
+	// Poses after the last two simulation steps. Dynamic rigid bodies' transforms are interpolated between them to the time of the frame
+	glm::vec3 previousPosition;
+	glm::quat previousRotation;
+	glm::vec3 currentPosition;
+	glm::quat currentRotation;
+
 	void applyForce(const glm::vec3& force);
 
 	void setTransform(const glm::vec3& position, const glm::quat& rotation = glm::vec3(0.0f));
@@ -157,6 +169,10 @@ struct CharacterController
 
 	glm::vec3 velocity;
 
+	// Positions after the last two simulation steps, interpolated between like rigid bodies' poses
+	glm::vec3 previousPosition;
+	glm::vec3 currentPosition;
+
 	void setLinearVelocity(const glm::vec3& velocity);
 
 	glm::vec3 getLinearVelocity() const;
@@ -201,6 +217,28 @@ struct CharacterControllerCreateInfo
 	}
 };
 
+/*
+Runs PhysX's tasks as jobs of the engine's JobSystem, so the simulation shares the job system's threads with the rest of the engine rather than competing
+with them from a pool of its own.
+*/
+class JobDispatcher : public physx::PxCpuDispatcher
+{
+private:
+	JobSystem& mJobSystem = JobSystem::instance();
+	JobCounter mCounter; // Counts PhysX's unfinished tasks
+
+public:
+	void submitTask(physx::PxBaseTask& task) override;
+
+	/*
+	\return The number of threads executing jobs, which PhysX uses to decide how finely to split its work.
+	*/
+	physx::PxU32 getWorkerCount() const override;
+
+	// Executes jobs on the calling thread until all submitted tasks have completed.
+	void wait();
+};
+
 class PhysicsSystem
 {
 private:
@@ -213,24 +251,26 @@ private:
 	ComponentManager<Transform>& mTransformManager = ComponentManager<Transform>::instance();
 	ComponentManager<RigidBody>& mRigidBodyManager = ComponentManager<RigidBody>::instance();
 	ComponentManager<CharacterController>& mCharacterControllerManager = ComponentManager<CharacterController>::instance();
+	ComponentManager<Inactive>& mInactiveManager = ComponentManager<Inactive>::instance();
 	WindowManager& mWindowManager = WindowManager::instance();
+	const TransformSystem& mTransformSystem = TransformSystem::instance();
 
-	const ComponentAddedCallback mRigidBodyComponentAddedCallback = std::bind(&PhysicsSystem::componentAdded, this, std::placeholders::_1);
+	const ComponentsAddedCallback mRigidBodyComponentsAddedCallback = std::bind(&PhysicsSystem::componentsAdded, this, std::placeholders::_1);
 	const ComponentRemovedCallback mRigidBodyComponentRemovedCallback = std::bind(&PhysicsSystem::componentRemoved, this, std::placeholders::_1);
-	const ComponentAddedCallback mControllerComponentAddedCallback = std::bind(&PhysicsSystem::controllerComponentAdded, this, std::placeholders::_1);
-	const ComponentRemovedCallback mControllerComponentRemovedCallback = std::bind(&PhysicsSystem::controllerComponentRemoved, this, std::placeholders::_1);
-
-	const TransformChangedCallback mStaticTransformChangedCallback = std::bind(&PhysicsSystem::staticTransformChanged, this, std::placeholders::_1);
+	const ComponentsAddedCallback mEntitiesDeactivatedCallback = std::bind(&PhysicsSystem::entitiesDeactivated, this, std::placeholders::_1);
+	const ComponentsRemovedCallback mEntitiesActivatedCallback = std::bind(&PhysicsSystem::entitiesActivated, this, std::placeholders::_1);
 
 	std::unordered_map<PxMaterialInfo, physx::PxMaterial*, PxMaterialInfoHasher> mMaterials;
 	std::vector<physx::PxCollection*> mCollections;
 
-	std::vector<EntityID> mStaticEntityIDs;
-	std::vector<EntityID> mDynamicEntityIDs;
-	std::vector<EntityID> mControllerEntityIDs;
+	EntitySet mStaticEntityIDs;
+	EntitySet mDynamicEntityIDs;
+	SystemEntitySet<Transform, CharacterController> mControllerEntityIDs = { std::bind(&PhysicsSystem::controllerComponentAdded, this, std::placeholders::_1), std::bind(&PhysicsSystem::controllerComponentRemoved, this, std::placeholders::_1) };
+
+	View<CharacterController, const Transform> mControllerView; // Moves controllers without marking their transforms as changed
+	View<const CharacterController, const Transform> mControllerPoseView; // Reads controllers without marking their transforms as changed
 
 	Composition mRigidBodyComposition;
-	Composition mCharacterControllerComposition;
 
 	physx::PxDefaultAllocator allocatorCallback;
 	physx::PxDefaultErrorCallback errorCallback;
@@ -240,7 +280,7 @@ private:
 	physx::PxPhysics* physics;
 	physx::PxScene* scene;
 	physx::PxCooking* cooking;
-	physx::PxCpuDispatcher* cpuDispatcher;
+	JobDispatcher cpuDispatcher;
 	physx::PxPvdSceneClient* pvdSceneClient;
 	physx::PxControllerManager* controllerManager;
 	physx::PxSerializationRegistry* serializationRegistry;
@@ -250,8 +290,30 @@ private:
 	double forwardDuration = 0.0;
 	double rightDuration = 0.0;
 
+	double mAccumulator = 0.0; // Time passed which has not been simulated yet, less than PHYSICS_TIMESTEP between updates
+	float mInterpolation = 0.0f;
+
+	// Dynamic rigid bodies which moved during the last step, and those which came to rest since transforms were last interpolated
+	std::vector<EntityID> mMovingEntityIDs;
+	std::vector<EntityID> mSettledEntityIDs;
+
+	bool mSimulating = false; // Whether a step has been simulated whose results have not been fetched
+	std::chrono::high_resolution_clock::time_point mSimulateStart; // Time the step being simulated started
+
 	PhysicsSystem();
 
+	/*
+	Moves character controllers and starts simulating the scene by PHYSICS_TIMESTEP. Character controllers must not be moved until fetchStep is called.
+	\param jump: Whether grounded character controllers jump.
+	*/
+	void simulateStep(const bool& jump);
+
+	// Waits for the step being simulated to complete and records the resulting poses.
+	void fetchStep();
+
+	// Places the transforms of dynamic rigid bodies and character controllers between their last two simulated poses.
+	void interpolateTransforms();
+
 public:
 	static PhysicsSystem& instance();
 
@@ -260,15 +322,40 @@ public:
 
 	physx::PxMaterial* getMaterial(const PxMaterialInfo& materialInfo);
 
-	void componentAdded(const Entity& entity);
+	void componentsAdded(const EntitySpan& entityIDs);
 	void componentRemoved(const Entity& entity);
 
+	// Removes the rigid bodies of deactivated entities from the scene without releasing them.
+	void entitiesDeactivated(const EntitySpan& entityIDs);
+	// Returns the rigid bodies of reactivated entities to the scene at their transforms' poses, at rest.
+	void entitiesActivated(const EntitySpan& entityIDs);
+
+	// Creates the PhysX controller of an entity which has just gained both a transform and a character controller.
 	void controllerComponentAdded(const Entity& entity);
+	// Releases the PhysX controller of an entity which is about to lose its transform or character controller.
 	void controllerComponentRemoved(const Entity& entity);
 
-	void update(const double& delta);
+	/*
+	Starts simulating as many fixed steps as the time passed allows, up to PHYSICS_MAX_STEPS. Every step but the last is completed before returning, the last is
+	simulated by the job system's threads until endStep is called, so other work such as rendering may be done meanwhile. While the step is simulated scene queries
+	return the state before the step, changes made to rigid bodies are buffered by PhysX until the step ends, and character controllers must not be moved.
+	\param delta: Time in seconds since the last frame.
+	*/
+	void beginStep(const double& delta);
+
+	/*
+	Waits for the step started by beginStep to complete, then interpolates transforms between the last two steps. The time spent simulating and the time spent
+	waiting are added to the scheduler's trace, the difference being the time the simulation overlapped other work.
+	*/
+	void endStep();
+
+	/*
+	\return Fraction of a step the last update lies past the last simulation step, the weight given to the current poses over the previous when interpolating.
+	*/
+	float interpolationFactor() const;
 
-	void staticTransformChanged(const Transform& transform) const;
+	// Moves static rigid bodies whose transforms changed during the last transform update.
+	void updateStaticBodies() const;
 
 	physx::PxRaycastBuffer raycast(const glm::vec3& origin, const glm::vec3& direction, const float& distance, const RigidBodyType& filter = UNDEFINED) const;
 };
@@ -0,0 +1,103 @@
+#pragma once
+#include "Vulkan.h"
+#include <cstddef>
+#include <type_traits>
+
+// Persistent field of a reflected component type.
+struct FieldInfo
+{
+	const char* name;
+	unsigned int offset; // Byte offset of the field within the component
+	unsigned int size;
+	unsigned int alignment;
+};
+
+#define REFLECT_FIELD(type, field) FieldInfo{ #field, offsetof(type, field), sizeof(type::field), alignof(decltype(type::field)) }
+
+/*
+Declares the persistent fields of a component type so whole pools of the component can be serialized at once. Specialize for a component type T as follows:
+template <> struct Reflection<T> { static constexpr FieldInfo fields[] = { REFLECT_FIELD(T, [field name]), ... }; };
+Fields must be listed in declaration order. Component types without a specialization are serialized one at a time via serialize<T>.
+*/
+template <typename T>
+struct Reflection {};
+
+template <typename T, typename = void>
+struct IsReflected : std::false_type {};
+
+template <typename T>
+struct IsReflected<T, std::void_t<decltype(Reflection<T>::fields)>> : std::true_type {};
+
+template <typename T>
+constexpr bool reflected = IsReflected<T>::value;
+
+/*
+\return The number of bytes the persistent fields of T occupy once packed together.
+*/
+template <typename T>
+constexpr unsigned int packedSize()
+{
+	unsigned int size = 0;
+	for (const FieldInfo& field : Reflection<T>::fields)
+		size += field.size;
+	return size;
+}
+
+/*
+Use to determine whether an array of T may be serialized with a single memcpy.
+\return True if T is trivially copyable and its persistent fields cover every byte of T besides padding, otherwise false.
+*/
+template <typename T>
+constexpr bool bulkCopyable()
+{
+	if (!std::is_trivially_copyable<T>::value)
+		return false;
+
+	unsigned int end = 0;
+	for (const FieldInfo& field : Reflection<T>::fields)
+	{
+		if (field.offset != (end + field.alignment - 1) / field.alignment * field.alignment)
+			return false; // Gap larger than padding, so T has fields which are not persistent
+		end = field.offset + field.size;
+	}
+	return (end + alignof(T) - 1) / alignof(T) * alignof(T) == sizeof(T);
+}
+
+/*
+\return The number of bytes each component of type T occupies once serialized as part of a pool. Padding is kept for types copied whole.
+*/
+template <typename T>
+constexpr unsigned int serializedSize()
+{
+	return bulkCopyable<T>() ? sizeof(T) : packedSize<T>();
+}
+
+/*
+Writes the persistent fields of a component, packed together.
+\param component: Component to write.
+\param write: Pointer to at least packedSize<T>() bytes, advanced past the written bytes.
+*/
+template <typename T>
+void writeFields(const T& component, char*& write)
+{
+	for (const FieldInfo& field : Reflection<T>::fields)
+	{
+		memcpy(write, reinterpret_cast<const char*>(&component) + field.offset, field.size);
+		write += field.size;
+	}
+}
+
+/*
+Reads the persistent fields of a component written by writeFields.
+\param read: Pointer to the packed fields, advanced past the read bytes.
+\param component: Component to write the fields to. Fields which are not persistent are left unchanged.
+*/
+template <typename T>
+void readFields(const char*& read, T& component)
+{
+	for (const FieldInfo& field : Reflection<T>::fields)
+	{
+		memcpy(reinterpret_cast<char*>(&component) + field.offset, read, field.size);
+		read += field.size;
+	}
+}
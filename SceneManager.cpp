@@ -1,5 +1,6 @@
 #include "SceneManager.h"
 #include "Transform.h"
+#include "EntityCommandBuffer.h"
 
 SceneManager& SceneManager::instance()
 {
@@ -9,11 +10,12 @@ SceneManager& SceneManager::instance()
 
 void SceneManager::destroyScene()
 {
+	// Destroy the whole scene in one batch so systems are notified once per component type
+	EntityCommandBuffer commandBuffer;
 	for (const EntityID& entityID : mSceneEntityIDs)
-	{
-		Entity entity(entityID);
-		entity.destroy();
-	}
+		commandBuffer.destroyEntity(Entity(entityID));
+	commandBuffer.playback();
+	mSceneEntityIDs.clear();
 }
 
 Entity SceneManager::createEntity(const std::string& name)
@@ -25,33 +27,31 @@ Entity SceneManager::createEntity(const std::string& name)
 
 void SceneManager::addEntity(const Entity& entity, const bool& children)
 {
-	mSceneEntityIDs.push_back(entity.ID());
+	mSceneEntityIDs.insert(entity.ID());
 	for (EntityAddedCallback* callback : mEntityAddedCallbacks)
 		(*callback)(entity);
 
 	if (children)
 	{
 		Transform& transform = entity.getComponent<Transform>();
-		for (unsigned int i = 0; i < transform.childrenIDs.length; i++)
-			addEntity(Entity(transform.childrenIDs[i]));
+		for (const EntityID& childID : transform.children())
+			addEntity(Entity(childID));
 	}
 }
 
 void SceneManager::removeEntity(Entity& entity, const bool& children)
 {
-	std::vector<EntityID>::iterator it = std::find(mSceneEntityIDs.begin(), mSceneEntityIDs.end(), entity.ID());
-	if (it != mSceneEntityIDs.end())
+	if (mSceneEntityIDs.erase(entity.ID()))
 	{
-		mSceneEntityIDs.erase(it);
 		for (EntityRemovedCallback* callback : mEntityRemovedCallbacks)
 			(*callback)(entity);
 	}
 	if (children)
 	{
 		Transform* transform = &entity.getComponent<Transform>();
-		while (transform->childrenIDs.length != 0)
+		while (transform->firstChildID)
 		{
-			Entity child(transform->childrenIDs[0]);
+			Entity child(transform->firstChildID);
 			removeEntity(child);
 			transform = &entity.getComponent<Transform>();
 		}
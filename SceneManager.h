@@ -10,7 +10,7 @@ class SceneManager
 private:
 	ComponentManager<Transform>& mTransformManager = ComponentManager<Transform>::instance();
 
-	std::vector<EntityID> mSceneEntityIDs;
+	EntitySet mSceneEntityIDs;
 	std::vector<EntityAddedCallback*> mEntityAddedCallbacks;
 	std::vector<EntityRemovedCallback*> mEntityRemovedCallbacks;
 
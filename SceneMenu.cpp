@@ -53,17 +53,16 @@ void SceneMenu::addEntityButton(const Entity& entity)
 
 void SceneMenu::removeEntityButton(const Entity& entity)
 {
+	static ComponentManager<Transform2D>& transform2DManager = ComponentManager<Transform2D>::instance();
+
 	bool found = false;
-	unsigned int i = 0;
-	Transform2D& menuTransform = mSceneMenu.getComponent<Transform2D>();
-	while (i < menuTransform.childrenIDs.length)
+	EntityID buttonID = transform2DManager.readComponent(mSceneMenu.ID()).firstChildID;
+	while (buttonID)
 	{
-		Entity button(menuTransform.childrenIDs[i]);
+		Entity button(buttonID);
+		buttonID = transform2DManager.readComponent(buttonID).nextSiblingID; // Read before the button is destroyed
 		if (found)
-		{
 			button.getComponent<Transform2D>().translate(glm::vec2(0.0f, -mButtonDimensions.y));
-			i++;
-		}
 		else if (button.getComponent<EntityButtonInfo>().sceneEntity == entity.ID())
 		{
 			destroyChildren(button);
@@ -71,8 +70,6 @@ void SceneMenu::removeEntityButton(const Entity& entity)
 			mNextButtonPosition.y -= mButtonDimensions.y;
 			found = true;
 		}
-		else
-			i++;
 	}
 }
 
@@ -0,0 +1,98 @@
+#include "Scheduler.h"
+#include <iostream>
+#include <climits>
+
+Scheduler& Scheduler::instance()
+{
+	static Scheduler instance;
+	return instance;
+}
+
+void Scheduler::addSystem(const SystemCreateInfo& createInfo)
+{
+	System system = { createInfo, {}, 0 };
+	unsigned int index = mSystems.size();
+
+	// The new system must run after every earlier system it conflicts with
+	for (System& other : mSystems)
+	{
+		if ((other.info.writes & (createInfo.reads | createInfo.writes)).any() || (createInfo.writes & other.info.reads).any())
+		{
+			other.dependents.push_back(index);
+			system.nDependencies++;
+		}
+	}
+	mSystems.push_back(system);
+}
+
+void Scheduler::schedule(const unsigned int& system)
+{
+	mJobSystem.schedule([this, system]() { execute(system); }, &mFrameCounter, mSystems[system].info.mainThread);
+}
+
+void Scheduler::execute(const unsigned int& system)
+{
+	double start = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - mFrameStart).count();
+	mSystems[system].info.update(mDeltaTime);
+	double end = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - mFrameStart).count();
+
+	// Release systems which were waiting on this one. They are scheduled before this job completes so the frame counter cannot reach zero early
+	std::vector<unsigned int> readySystems;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTrace.push_back({ mSystems[system].info.name, JobSystem::currentThread(), start, end });
+
+		for (const unsigned int& dependent : mSystems[system].dependents)
+		{
+			if (--mRemainingDependencies[dependent] == 0)
+				readySystems.push_back(dependent);
+		}
+	}
+	for (const unsigned int& readySystem : readySystems)
+		schedule(readySystem);
+}
+
+void Scheduler::run(const double& deltaTime)
+{
+	mDeltaTime = deltaTime;
+	mFrameStart = std::chrono::high_resolution_clock::now();
+	mTrace.clear();
+
+	mRemainingDependencies.resize(mSystems.size());
+	for (unsigned int i = 0; i < mSystems.size(); i++)
+		mRemainingDependencies[i] = mSystems[i].nDependencies;
+
+	for (unsigned int i = 0; i < mSystems.size(); i++)
+	{
+		if (mSystems[i].nDependencies == 0)
+			schedule(i);
+	}
+
+	// The main thread runs main thread systems as they become ready, and helps with other jobs while it would otherwise wait
+	mJobSystem.wait(mFrameCounter);
+}
+
+void Scheduler::addTrace(const char* name, const std::chrono::high_resolution_clock::time_point& start, const std::chrono::high_resolution_clock::time_point& end, const unsigned int& thread)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mTrace.push_back({ name, thread, std::chrono::duration<double, std::milli>(start - mFrameStart).count(), std::chrono::duration<double, std::milli>(end - mFrameStart).count() });
+}
+
+const std::vector<SystemTrace>& Scheduler::trace() const
+{
+	return mTrace;
+}
+
+void Scheduler::printTrace() const
+{
+	std::vector<SystemTrace> trace = mTrace;
+	std::sort(trace.begin(), trace.end(), [](const SystemTrace& a, const SystemTrace& b) { return a.start < b.start; });
+	for (const SystemTrace& entry : trace)
+	{
+		if (entry.thread == UINT_MAX)
+			std::cout << "[External] ";
+		else
+			std::cout << "[Thread " << entry.thread << "] ";
+		std::cout << entry.name << ": " << entry.start << "ms - " << entry.end << "ms" << std::endl;
+	}
+}
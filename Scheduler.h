@@ -0,0 +1,104 @@
+#pragma once
+#include "ComponentManager.h"
+#include "JobSystem.h"
+#include <chrono>
+#include <algorithm>
+
+typedef std::function<void(const double& deltaTime)> SystemUpdateFunction;
+
+/*
+\return A composition containing the component types Ts.
+*/
+template <typename... Ts>
+Composition componentComposition()
+{
+	return (Composition() | ... | ComponentManager<Ts>::instance().bit);
+}
+
+// Describes a per-frame update of a system and the component types it accesses, so the scheduler can determine which updates may run concurrently.
+struct SystemCreateInfo
+{
+	const char* name;
+	SystemUpdateFunction update;
+	Composition reads; // Component types read by the update, including from callbacks it invokes
+	Composition writes; // Component types written by the update, including from callbacks it invokes
+	bool mainThread; // Whether the update must run on the main thread, such as to use GLFW
+};
+
+// Records when a system's update ran during the last frame.
+struct SystemTrace
+{
+	const char* name;
+	unsigned int thread; // Job system thread index, 0 is the main thread. UINT_MAX for work done by threads outside the job system
+	double start; // Milliseconds since the start of the frame
+	double end;
+};
+
+/*
+Runs the updates of all systems once per frame. Two updates conflict if either writes a component type the other reads or writes;
+conflicting updates run in the order the systems were added while all others may run at the same time as jobs on the job system.
+*/
+class Scheduler
+{
+private:
+	struct System
+	{
+		SystemCreateInfo info;
+		std::vector<unsigned int> dependents; // Indices of systems which conflict with, and were added after, this system
+		unsigned int nDependencies;
+	};
+
+	JobSystem& mJobSystem = JobSystem::instance();
+
+	std::vector<System> mSystems;
+
+	std::mutex mMutex; // Guards mRemainingDependencies and mTrace while a frame is running
+	std::vector<unsigned int> mRemainingDependencies;
+	JobCounter mFrameCounter; // Counts the systems yet to complete this frame
+
+	double mDeltaTime = 0.0;
+	std::chrono::high_resolution_clock::time_point mFrameStart;
+	std::vector<SystemTrace> mTrace;
+
+	Scheduler() {};
+
+	void schedule(const unsigned int& system);
+
+	void execute(const unsigned int& system);
+
+public:
+	static Scheduler& instance();
+
+	Scheduler(const Scheduler& copy) = delete;
+
+	/*
+	Adds a system's update to be run every frame. Must not be called while a frame is running.
+	\param createInfo: Description of the update.
+	*/
+	void addSystem(const SystemCreateInfo& createInfo);
+
+	/*
+	Runs every system's update once, returning once all have completed. Must be called from the main thread, which executes jobs while it waits.
+	\param deltaTime: Time in seconds since the last frame.
+	*/
+	void run(const double& deltaTime);
+
+	/*
+	Records work done during the current frame other than a system's update, such as work a system started which continues on threads outside the job system.
+	\param name: Name of the work.
+	\param start: Time the work started.
+	\param end: Time the work ended.
+	\param thread: Job system thread index of the thread which did the work, or UINT_MAX.
+	*/
+	void addTrace(const char* name, const std::chrono::high_resolution_clock::time_point& start, const std::chrono::high_resolution_clock::time_point& end, const unsigned int& thread);
+
+	/*
+	\return When each system's update, and other work recorded with addTrace, ran during the last frame, in the order they completed.
+	*/
+	const std::vector<SystemTrace>& trace() const;
+
+	/*
+	Prints the trace of the last frame to the console.
+	*/
+	void printTrace() const;
+};
@@ -5,6 +5,12 @@
 SnakeSystem::SnakeSystem()
 {
 	mSerializedSegment = readFile("Segment.txt");
+	mSerializedFood = readFile("Food.txt");
+}
+
+void SnakeSystem::moveFood()
+{
+	mTransformManager.getComponent(mFood).position = glm::vec3(float(rand() % GRID_WIDTH - (GRID_WIDTH / 2.0f)) * SQUARE_SIZE, 0.0f, float(rand() % GRID_HEIGHT - (GRID_HEIGHT / 2.0f)) * SQUARE_SIZE);
 }
 
 void SnakeSystem::destroySnake()
@@ -22,6 +28,11 @@ void SnakeSystem::destroySnake()
 	snakeEntity.destroy();
 	mSnake = 0;
 
+	Entity foodEntity(mFood);
+	destroyChildren(foodEntity);
+	foodEntity.destroy();
+	mFood = 0;
+
 	Entity(mLengthText).destroy();
 	mLengthText = 0;
 }
@@ -68,6 +79,11 @@ void SnakeSystem::startGame()
 	deserialize(readFile("Head.txt"), head);
 	Transform& transform = mTransformManager.getComponent(mSnake);
 	transform.addChild(head);
+
+	Entity food("Food");
+	deserialize(mSerializedFood, food);
+	mFood = food.ID();
+	moveFood();
 }
 
 void SnakeSystem::menu()
@@ -96,9 +112,10 @@ void SnakeSystem::update(const float& deltaTime)
 		Transform* transform = &mTransformManager.getComponent(mSnake);
 		Snake& snake = mSnakeManager.getComponent(mSnake);
 
-		Transform& headTransform = mTransformManager.getComponent(transform->childrenIDs[0]);
+		const EntityID headID = transform->firstChildID;
+		Transform& headTransform = mTransformManager.getComponent(headID);
 
-		mTransformManager.getComponent(transform->childrenIDs[0]).translate(glm::vec3(snake._velocity.x, 0.0f, snake._velocity.y) * deltaTime);
+		mTransformManager.getComponent(transform->firstChildID).translate(glm::vec3(snake._velocity.x, 0.0f, snake._velocity.y) * deltaTime);
 
 		glm::vec2 headDirection = glm::normalize(snake._velocity);
 		glm::vec2 tailDirection = -headDirection;
@@ -111,25 +128,26 @@ void SnakeSystem::update(const float& deltaTime)
 			for (unsigned int i = 0; i < ray.getNbAnyHits(); i++)
 			{
 				const physx::PxRaycastHit hit = ray.getAnyHit(i);
-				Entity hitEntity(*((unsigned int*)hit.actor->userData));
-				std::string name = hitEntity.name();
-				if (name == "Food")
+				const EntityID hitID = *((unsigned int*)hit.actor->userData);
+				if (hitID == headID)
+					continue;
+
+				if (hitID == mFood)
 				{
-					hitEntity.getComponent<Transform>().position = glm::vec3(float(rand() % GRID_WIDTH - (GRID_WIDTH / 2.0f)) * SQUARE_SIZE, 0.0f, float(rand() % GRID_HEIGHT - (GRID_HEIGHT / 2.0f)) * SQUARE_SIZE);
+					moveFood();
 
 					Entity segment("Segment");
 					deserialize(mSerializedSegment, segment);
 
 					transform = &mTransformManager.getComponent(mSnake);
-					segment.getComponent<Transform>().position = mTransformManager.getComponent(transform->childrenIDs[transform->childrenIDs.length - 1]).position;
+					segment.getComponent<Transform>().position = mTransformManager.getComponent(transform->lastChildID).position;
 					transform->addChild(segment);
+					continue;
 				}
 
-				if (name == "Segment" || name == "Walls")
-				{
-					menu();
-					return;
-				}
+				// Anything else in front of the head is either a segment or a wall
+				menu();
+				return;
 			}
 		}
 
@@ -152,14 +170,14 @@ void SnakeSystem::update(const float& deltaTime)
 				snake._velocity = snake._queuedDirection * snake.movementSpeed;
 				snake._queuedDirection = glm::vec2(0.0f, 0.0f);
 
-				if (transform->childrenIDs.length > 1)
+				if (transform->nChildren > 1)
 					snake._turns.push({ nextGrid, tailDirection });
 			}
 		}
 
 		glm::vec2 segmentPosition = glm::vec2(headTransform.position.x, headTransform.position.z);
 		int turnIndex = snake._turns.length - 1;
-		for (unsigned int i = 1; i < transform->childrenIDs.length; i++)
+		for (EntityID segmentID = headTransform.nextSiblingID; segmentID; segmentID = mTransformManager.readComponent(segmentID).nextSiblingID)
 		{
 			segmentPosition += tailDirection * SQUARE_SIZE;
 			if (turnIndex >= 0)
@@ -173,13 +191,13 @@ void SnakeSystem::update(const float& deltaTime)
 				}
 			}
 
-			mRigidBodyManager.getComponent(transform->childrenIDs[i]).setTransform(glm::vec3(segmentPosition.x, 0.0f, segmentPosition.y));
+			mRigidBodyManager.getComponent(segmentID).setTransform(glm::vec3(segmentPosition.x, 0.0f, segmentPosition.y));
 		}
 		if (turnIndex >= 0)
 			snake._turns.remove(0);
 
 		UIText& lengthText = mUITextManager.getComponent(mLengthText);
-		lengthText.text = "Length: " + std::to_string(transform->childrenIDs.length);
+		lengthText.text = "Length: " + std::to_string(transform->nChildren);
 	}
 }
 
@@ -56,11 +56,16 @@ private:
 	const KeyCallback rightCallback = std::bind(&SnakeSystem::rightPressed, this);
 
 	std::vector<char> mSerializedSegment;
+	std::vector<char> mSerializedFood;
 
 	EntityID mSnake = 0;
+	EntityID mFood = 0; // Identified by ID rather than by name so the game does not depend on ENTITY_NAMES
 	EntityID mMenu = 0;
 	EntityID mLengthText = 0;
 
+	// Moves the food to a random square of the grid.
+	void moveFood();
+
 	void destroySnake();
 	void destroyMenu();
 
@@ -2,6 +2,7 @@
 #include "Mesh.h"
 #include "stb_image.h"
 #include "float16.h"
+#include "JobSystem.h"
 
 // Stores information returned by getFormatInfo, a few parameters that do not seem to be easily retrievable
 struct FormatInfo
@@ -378,44 +379,47 @@ Cubemap::Cubemap(CubemapInfo cubemapInfo)
     #pragma region Create cubemap resources
 	stbi_set_flip_vertically_on_load(false);
 
-	// Load images
+	// Load images, decoding each face as a separate job
 	void* textureData[6];
-	int width, height, channels;
+	int widths[6], heights[6];
 	bool hdr = cubemapInfo.format == VK_FORMAT_R16_SFLOAT || cubemapInfo.format == VK_FORMAT_R16G16_SFLOAT || cubemapInfo.format == VK_FORMAT_R16G16B16_SFLOAT || cubemapInfo.format == VK_FORMAT_R16G16B16A16_SFLOAT || cubemapInfo.format == VK_FORMAT_R32_SFLOAT || cubemapInfo.format == VK_FORMAT_R32G32_SFLOAT || cubemapInfo.format == VK_FORMAT_R32G32B32_SFLOAT || cubemapInfo.format == VK_FORMAT_R32G32B32A32_SFLOAT;
-	if (hdr)
+	JobSystem::instance().parallelFor(0, 6, 1, [&](const unsigned int& begin, const unsigned int& end)
 	{
-		if (formatInfo.bytesPerChannel == 4)
+		for (unsigned int i = begin; i < end; i++)
 		{
-			for (unsigned int i = 0; i < 6; i++)
+			int channels;
+			if (hdr)
 			{
-				textureData[i] = stbi_loadf(cubemapInfo.directories[i].c_str(), &width, &height, &channels, formatInfo.nChannels);
-				assert(("[ERROR] STBI failed to load image", textureData[i]));
+				if (formatInfo.bytesPerChannel == 4)
+				{
+					textureData[i] = stbi_loadf(cubemapInfo.directories[i].c_str(), &widths[i], &heights[i], &channels, formatInfo.nChannels);
+					assert(("[ERROR] STBI failed to load image", textureData[i]));
+				}
+				else if (formatInfo.bytesPerChannel == 2)
+				{
+					float* tempData = stbi_loadf(cubemapInfo.directories[i].c_str(), &widths[i], &heights[i], &channels, formatInfo.nChannels);
+					assert(("[ERROR] STBI failed to load image", tempData));
+
+					const unsigned long long nElements = (unsigned long long)widths[i] * heights[i] * formatInfo.nChannels;
+					textureData[i] = new float16[nElements];
+					for (unsigned long long j = 0; j < nElements; j++)
+						((float16*)textureData[i])[j] = floatToFloat16(tempData[j]);
+
+					stbi_image_free((void*)tempData);
+				}
 			}
-		}
-		else if (formatInfo.bytesPerChannel == 2)
-		{
-			for (unsigned int i = 0; i < 6; i++)
+			else
 			{
-				float* tempData = stbi_loadf(cubemapInfo.directories[i].c_str(), &width, &height, &channels, formatInfo.nChannels);
-				assert(("[ERROR] STBI failed to load image", tempData));
-
-				const unsigned long long nElements = (unsigned long long)width * height * formatInfo.nChannels;
-				textureData[i] = new float16[nElements];
-				for (unsigned long long j = 0; j < nElements; j++)
-					((float16*)textureData[i])[j] = floatToFloat16(tempData[j]);
-
-				stbi_image_free((void*)tempData);
+				textureData[i] = stbi_load(cubemapInfo.directories[i].c_str(), &widths[i], &heights[i], &channels, formatInfo.nChannels);
+				assert(("[ERROR] STBI failed to load image", textureData[i]));
 			}
 		}
-	}
-	else
-	{
-		for (unsigned int i = 0; i < 6; i++)
-		{
-			textureData[i] = stbi_load(cubemapInfo.directories[i].c_str(), &width, &height, &channels, formatInfo.nChannels);
-			assert(("[ERROR] STBI failed to load image", textureData[i]));
-		}
-	}
+	});
+
+	const int width = widths[0];
+	const int height = heights[0];
+	for (unsigned int i = 1; i < 6; i++)
+		assert(("[ERROR] Cubemap faces must have the same dimensions", widths[i] == width && heights[i] == height));
 
 	const unsigned long long layerSize = (unsigned long long)width * height * formatInfo.nChannels * formatInfo.bytesPerChannel;
 	const VkDeviceSize imageSize = 6 * layerSize;
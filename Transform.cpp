@@ -1,6 +1,8 @@
 #include "Transform.h"
 #include "SceneMenu.h"
+#include "JobSystem.h"
 #include <iostream>
+#include <algorithm>
 
 void print(const glm::vec2& vec2)
 {
@@ -70,13 +72,72 @@ void Transform::enlarge(const glm::vec3& factor)
 	scale *= factor;
 }
 
+/*
+Unlinks a transform from its parent's list of children, leaving its parent ID unchanged.
+\param manager: Component manager of the transform type.
+\param parent: Parent of the transform.
+\param child: Transform to unlink.
+*/
+template <typename T>
+void unlinkChild(ComponentManager<T>& manager, T& parent, T& child)
+{
+	if (child.previousSiblingID)
+		manager.getComponent(child.previousSiblingID).nextSiblingID = child.nextSiblingID;
+	else
+		parent.firstChildID = child.nextSiblingID;
+
+	if (child.nextSiblingID)
+		manager.getComponent(child.nextSiblingID).previousSiblingID = child.previousSiblingID;
+	else
+		parent.lastChildID = child.previousSiblingID;
+
+	child.previousSiblingID = NULL;
+	child.nextSiblingID = NULL;
+	parent.nChildren--;
+}
+
+/*
+Links a transform to the end of a parent's list of children, detaching it from its current parent first.
+\param manager: Component manager of the transform type.
+\param parent: New parent of the transform.
+\param child: Transform to link.
+*/
+template <typename T>
+void linkChild(ComponentManager<T>& manager, T& parent, T& child)
+{
+	assert(("[ERROR] Attempting to make a transform a child of itself", parent.entityID != child.entityID));
+	if (child.parentID)
+		unlinkChild(manager, manager.getComponent(child.parentID), child);
+
+	child.parentID = parent.entityID;
+	child.previousSiblingID = parent.lastChildID;
+	if (parent.lastChildID)
+		manager.getComponent(parent.lastChildID).nextSiblingID = child.entityID;
+	else
+		parent.firstChildID = child.entityID;
+	parent.lastChildID = child.entityID;
+	parent.nChildren++;
+}
+
+// Makes a transform a root without children, as transforms are added with the links of the transform they were copied or deserialized from.
+template <typename T>
+void resetLinks(T& transform)
+{
+	transform.parentID = NULL;
+	transform.firstChildID = NULL;
+	transform.lastChildID = NULL;
+	transform.previousSiblingID = NULL;
+	transform.nextSiblingID = NULL;
+	transform.nChildren = 0;
+}
+
 void Transform::addChild(const Entity& child)
 {
 	static TransformSystem& transformSystem = TransformSystem::instance();
-	transformSystem.mEntityIDs.erase(std::find(transformSystem.mEntityIDs.begin(), transformSystem.mEntityIDs.end(), child.ID()));
+	transformSystem.mEntityIDs.erase(child.ID());
+	transformSystem.mHierarchy.dirty = true;
 
-	child.getComponent<Transform>().parentID = entityID;
-	childrenIDs.push(child.ID());
+	linkChild(transformSystem.mTransformManager, *this, child.getComponent<Transform>());
 
 	#if SCENE_MENU == 1
 	static SceneMenu& sceneMenu = SceneMenu::instance();
@@ -88,11 +149,13 @@ void Transform::removeChild(const Entity& child)
 {
 	static TransformSystem& transformSystem = TransformSystem::instance();
 
-	child.getComponent<Transform>().parentID = NULL;
+	Transform& childTransform = child.getComponent<Transform>();
+	assert(("[ERROR] Attempting to remove a transform from a parent it is not a child of", childTransform.parentID == entityID));
+	unlinkChild(transformSystem.mTransformManager, *this, childTransform);
+	childTransform.parentID = NULL;
 
-	transformSystem.mEntityIDs.push_back(child.ID());
-
-	childrenIDs.remove(childrenIDs.find(child.ID()));
+	transformSystem.mEntityIDs.insert(child.ID());
+	transformSystem.mHierarchy.dirty = true;
 
 	#if SCENE_MENU == 1
 	static SceneMenu& sceneMenu = SceneMenu::instance();
@@ -100,23 +163,16 @@ void Transform::removeChild(const Entity& child)
 	#endif
 }
 
-void Transform::subscribeChangedEvent(const TransformChangedCallback* callback)
-{
-	changedCallbacks.push((TransformChangedCallback*)callback);
-}
-
-void Transform::unsubscribeChangedEvent(const TransformChangedCallback* callback)
+ChildRange<Transform> Transform::children() const
 {
-	changedCallbacks.remove(changedCallbacks.find((TransformChangedCallback*)callback));
+	return { firstChildID };
 }
 
 TransformCreateInfo::operator Transform() const
 {
 	Transform transform = {};
 	transform.matrix = glm::mat4(1.0f);
-	transform.lastPosition = glm::vec3(0.0f);
-	transform.lastRotation = glm::vec3(0.0f);
-	transform.lastScale = glm::vec3(1.0f);
+	transform.normalMatrix = glm::mat3(1.0f);
 	transform.position = position;
 	transform.rotation = rotation;
 	transform.scale = scale;
@@ -200,38 +256,34 @@ void Transform2D::enlarge(const glm::vec2& factor)
 void Transform2D::addChild(const Entity& child)
 {
 	TransformSystem& transformSystem = TransformSystem::instance();
-	transformSystem.mEntity2DIDs.erase(std::find(transformSystem.mEntity2DIDs.begin(), transformSystem.mEntity2DIDs.end(), child.ID()));
+	transformSystem.mEntity2DIDs.erase(child.ID());
+	transformSystem.mHierarchy2D.dirty = true;
 
-	child.getComponent<Transform2D>().parentID = entityID;
-	childrenIDs.push(child.ID());
+	linkChild(transformSystem.mTransform2DManager, *this, child.getComponent<Transform2D>());
 }
 
 void Transform2D::removeChild(const Entity& child)
 {
-	child.getComponent<Transform2D>().parentID = NULL;
-
-	TransformSystem::instance().mEntity2DIDs.push_back(child.ID());
+	TransformSystem& transformSystem = TransformSystem::instance();
 
-	childrenIDs.remove(childrenIDs.find(child.ID()));
-}
+	Transform2D& childTransform = child.getComponent<Transform2D>();
+	assert(("[ERROR] Attempting to remove a transform from a parent it is not a child of", childTransform.parentID == entityID));
+	unlinkChild(transformSystem.mTransform2DManager, *this, childTransform);
+	childTransform.parentID = NULL;
 
-void Transform2D::subscribeChangedEvent(const Transform2DChangedCallback* callback)
-{
-	changedCallbacks.push((Transform2DChangedCallback*)callback);
+	transformSystem.mEntity2DIDs.insert(child.ID());
+	transformSystem.mHierarchy2D.dirty = true;
 }
 
-void Transform2D::unsubscribeChangedEvent(const Transform2DChangedCallback* callback)
+ChildRange<Transform2D> Transform2D::children() const
 {
-	changedCallbacks.remove(changedCallbacks.find((Transform2DChangedCallback*)callback));
+	return { firstChildID };
 }
 
 Transform2DCreateInfo::operator Transform2D() const
 {
 	Transform2D transform = {};
 	transform.matrix = glm::mat3(1.0f);
-	transform.lastPosition = glm::vec2(0.0f);
-	transform.lastRotation = 0.0f;
-	transform.lastScale = glm::vec2(1.0f);
 	transform.position = position;
 	transform.rotation = rotation;
 	transform.scale = scale;
@@ -242,6 +294,18 @@ Transform2DCreateInfo::operator Transform2D() const
 	return transform;
 }
 
+// Combines which properties of a transform changed into TransformChangeFlags.
+inline unsigned char changeFlags(const bool& positionChanged, const bool& rotationChanged, const bool& scaleChanged)
+{
+	return (positionChanged ? POSITION_CHANGED : 0) | (rotationChanged ? ROTATION_CHANGED : 0) | (scaleChanged ? SCALE_CHANGED : 0);
+}
+
+// Sorts changes by entity slot so consumers access component storage in order.
+inline void sortChanges(std::vector<TransformChange>& changes)
+{
+	std::sort(changes.begin(), changes.end(), [](const TransformChange& a, const TransformChange& b) { return Entity::indexFromID(a.entityID) < Entity::indexFromID(b.entityID); });
+}
+
 TransformSystem::TransformSystem()
 {
 	mTransformManager.subscribeAddedEvent(&mComponentAddedCallback);
@@ -250,145 +314,348 @@ TransformSystem::TransformSystem()
 	mTransform2DManager.subscribeRemovedEvent(&mComponent2DRemovedCallback);
 }
 
-void TransformSystem::updateTransform(const EntityID& entityID) const
+// Composes the local matrix of a 3D transform from its properties.
+inline glm::mat4 composeMatrix(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
 {
-	Transform& transform = mTransformManager.getComponent(entityID);
-	if (transform.dynamic)
-	{
-		// Check for change in position, rotation, and scale.
-		transform.positionChanged = transform.position != transform.lastPosition;
-		transform.rotationChanged = transform.rotation != transform.lastRotation;
-		transform.scaleChanged = transform.scale != transform.lastScale;
-
-		if (transform.parentID)
-		{
-			const Transform& parentTransform = mTransformManager.getComponent(transform.parentID);
+	return glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+}
 
-			// World position is also changed if it's parents position, rotation, or scale has changed.
-			transform.positionChanged |= parentTransform.positionChanged || parentTransform.rotationChanged || parentTransform.scaleChanged;
+// Composes the local matrix of a 2D transform from its properties.
+inline glm::mat4 composeMatrix(const glm::vec2& position, const float& rotation, const glm::vec2& scale)
+{
+	return glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f)) * glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(scale, 1.0f));
+}
 
-			// World rotation is also changed if it's parents rotation has changed.
-			transform.rotationChanged |= parentTransform.rotationChanged;
+// Composes the matrices of several 3D nodes in batches, along with their normal matrices.
+inline void composeMatrices(TransformHierarchy3D& hierarchy, const std::vector<unsigned int>& nodes, glm::mat4* matrices, glm::mat3* normalMatrices)
+{
+	composeTransforms(hierarchy.positions.data(), hierarchy.rotations.data(), hierarchy.scales.data(), nodes.data(), nodes.size(), matrices, normalMatrices);
+}
 
-			// Scale is also changed if it's parents scale has changed.
-			transform.scaleChanged |= parentTransform.scaleChanged;
+// Composes the matrices of several 2D nodes. 2D transforms have no normal matrices.
+inline void composeMatrices(TransformHierarchy2D& hierarchy, const std::vector<unsigned int>& nodes, glm::mat4* matrices, glm::mat3* normalMatrices)
+{
+	for (const unsigned int& node : nodes)
+		matrices[node] = composeMatrix(hierarchy.positions[node], hierarchy.rotations[node], hierarchy.scales[node]);
+}
 
-			if (transform.positionChanged || transform.rotationChanged || transform.scaleChanged)
-			{
-				// Transformation matrix must be updated if any change has occurred.
-				transform.matrix = parentTransform.matrix * glm::translate(glm::mat4(1.0f), transform.position) * glm::mat4_cast(transform.rotation) * glm::scale(glm::mat4(1.0f), transform.scale);
+inline glm::quat combineRotations(const glm::quat& parentRotation, const glm::quat& rotation)
+{
+	return parentRotation * rotation;
+}
 
-				if (transform.positionChanged)
-				{
-					glm::vec4 temp = parentTransform.matrix * glm::vec4(transform.position, 1.0f);
-					transform.worldPosition = glm::vec3(temp.x, temp.y, temp.z); // Update world position.
-				}
+inline float combineRotations(const float& parentRotation, const float& rotation)
+{
+	return parentRotation + rotation;
+}
 
-				if (transform.rotationChanged)
-					transform.worldRotation = parentTransform.worldRotation * transform.rotation; // Update world rotation.
+/*
+Flattens the hierarchies beneath a set of roots into a TransformHierarchy, depth first, copying each transform's current state.
+\param manager: Component manager of the transform type.
+\param rootIDs: IDs of the entities whose transforms have no parent.
+\param hierarchy: Hierarchy to rebuild.
+*/
+template <typename T, typename Hierarchy>
+void flattenHierarchy(const ComponentManager<T>& manager, const EntitySet& rootIDs, Hierarchy& hierarchy)
+{
+	hierarchy.resize(manager.size());
 
-				if (transform.scaleChanged)
-					transform.worldScale = parentTransform.worldScale * transform.scale; // Update world scale.
+	// Entities yet to be visited paired with the node index of their parent. Children are pushed in reverse so they are visited in order
+	std::vector<std::pair<EntityID, unsigned int>> stack;
+	unsigned int node = 0;
+	for (const EntityID& rootID : rootIDs)
+	{
+		stack.push_back({ rootID, NO_PARENT });
+		while (!stack.empty())
+		{
+			std::pair<EntityID, unsigned int> next = stack.back();
+			stack.pop_back();
 
-				// Invoke changed callbacks.
-				for (unsigned int i = 0; i < transform.changedCallbacks.length; i++)
-					(*transform.changedCallbacks[i])(transform);
+			hierarchy.entityIDs[node] = next.first;
+			hierarchy.parents[node] = next.second;
 
-				transform.lastPosition = transform.position;
-				transform.lastRotation = transform.rotation;
-				transform.lastScale = transform.scale;
-			}
+			for (EntityID childID = manager.readComponent(next.first).lastChildID; childID; childID = manager.readComponent(childID).previousSiblingID)
+				stack.push_back({ childID, node });
+			node++;
 		}
-		else
+	}
+	assert(("[ERROR] Transform hierarchy contains a transform which is not reachable from any root", node == hierarchy.size()));
+
+	// Group consecutive root hierarchies into ranges of at least TRANSFORM_JOB_SIZE nodes. The partition only depends on the hierarchy, never on the number of threads
+	unsigned int nRanges = 0;
+	for (unsigned int i = 0; i < hierarchy.size(); i++)
+	{
+		if (hierarchy.parents[i] != NO_PARENT)
+			continue;
+
+		// The previous root's hierarchy ends just before this root, so the last range's size includes every descendant of its roots
+		if (nRanges == 0 || i - hierarchy.ranges[nRanges - 1].begin >= TRANSFORM_JOB_SIZE)
 		{
-			if (transform.positionChanged || transform.rotationChanged || transform.scaleChanged)
-			{
-				transform.matrix = glm::translate(glm::mat4(1.0f), transform.position) * glm::mat4_cast(transform.rotation) * glm::scale(glm::mat4(1.0f), transform.scale);
+			if (nRanges == hierarchy.ranges.size())
+				hierarchy.ranges.emplace_back();
+			hierarchy.ranges[nRanges].begin = i;
+			nRanges++;
+		}
+		hierarchy.ranges[nRanges - 1].end = i + 1;
+	}
+	hierarchy.ranges.resize(nRanges);
 
-				transform.worldPosition = transform.position;
-				transform.worldRotation = transform.rotation;
-				transform.worldScale = transform.scale;
+	// Descendants follow their ancestors so visiting nodes in reverse extends each parent's subtree by its children's
+	for (unsigned int i = 0; i < hierarchy.size(); i++)
+		hierarchy.subtreeEnds[i] = i + 1;
+	for (unsigned int i = hierarchy.size(); i > 0; i--)
+	{
+		if (hierarchy.parents[i - 1] != NO_PARENT)
+			hierarchy.subtreeEnds[hierarchy.parents[i - 1]] = std::max(hierarchy.subtreeEnds[hierarchy.parents[i - 1]], hierarchy.subtreeEnds[i - 1]);
+	}
 
-				for (unsigned int i = 0; i < transform.changedCallbacks.length; i++)
-					(*transform.changedCallbacks[i])(transform);
+	// Ranges end with the end of their last root's hierarchy
+	for (TransformRange& range : hierarchy.ranges)
+		range.end = hierarchy.subtreeEnds[range.end - 1];
 
-				transform.lastPosition = transform.position;
-				transform.lastRotation = transform.rotation;
-				transform.lastScale = transform.scale;
-			}
+	for (unsigned int i = 0; i < hierarchy.size(); i++)
+	{
+		unsigned int slot = Entity::indexFromID(hierarchy.entityIDs[i]);
+		if (slot >= hierarchy.nodes.size())
+			hierarchy.nodes.resize(slot + 1);
+		hierarchy.nodes[slot] = i;
+
+		const T& transform = manager.readComponent(hierarchy.entityIDs[i]);
+		hierarchy.dynamic[i] = transform.dynamic;
+		hierarchy.positions[i] = transform.position;
+		hierarchy.rotations[i] = transform.rotation;
+		hierarchy.scales[i] = transform.scale;
+		hierarchy.worldRotations[i] = transform.worldRotation;
+		hierarchy.worldScales[i] = transform.worldScale;
+		hierarchy.localMatrices[i] = hierarchy.parents[i] != NO_PARENT ? composeMatrix(transform.position, transform.rotation, transform.scale) : glm::mat4(1.0f); // Roots only use their world matrix
+		hierarchy.worldMatrices[i] = transform.matrix;
+		if constexpr (std::is_same<T, Transform>::value)
+		{
+			hierarchy.localNormalMatrices[i] = hierarchy.parents[i] != NO_PARENT ? normalMatrix(transform.rotation, transform.scale) : glm::mat3(1.0f);
+			hierarchy.worldNormalMatrices[i] = transform.normalMatrix;
 		}
-
-		// Update children.
-		for (unsigned int i = 0; i < transform.childrenIDs.length; i++)
-			updateTransform(transform.childrenIDs[i]);
 	}
+	hierarchy.dirty = false;
 }
 
-void TransformSystem::updateTransform2D(const EntityID& entityID) const
+/*
+Marks every transform changed since a tick along with its ancestors, and collects the roots of the hierarchies containing them into the ranges they lie within.
+Each ancestor is marked at most once, so the cost is proportional to the number of changed transforms rather than the size of the hierarchy.
+\param manager: Component manager of the transform type.
+\param hierarchy: Flattened hierarchy of the transform type.
+\param lastTick: Tick at which the last update ended.
+*/
+template <typename T, typename Hierarchy>
+void markChanges(const ComponentManager<T>& manager, Hierarchy& hierarchy, const ChangeTick& lastTick)
 {
-	Transform2D& transform = mTransform2DManager.getComponent(entityID);
+	hierarchy.changedIDs.clear();
+	hierarchy.dirtyRoots.clear();
+	manager.changedSince(lastTick, hierarchy.changedIDs);
 
-	if (transform.dynamic)
+	for (const EntityID& entityID : hierarchy.changedIDs)
 	{
-		// Check for change in position, rotation, and scale.
-		transform.positionChanged = transform.position != transform.lastPosition;
-		transform.rotationChanged = transform.rotation != transform.lastRotation;
-		transform.scaleChanged = transform.scale != transform.lastScale;
+		unsigned int node = hierarchy.nodes[Entity::indexFromID(entityID)];
+		bool newlyMarked = !hierarchy.marks[node];
+		hierarchy.marks[node] |= TRANSFORM_CHANGED;
+		if (newlyMarked)
+			hierarchy.markedNodes.push_back(node);
+
+		// Ancestors of an already marked node, including its root, have been marked already
+		while (newlyMarked && hierarchy.parents[node] != NO_PARENT)
+		{
+			node = hierarchy.parents[node];
+			newlyMarked = !hierarchy.marks[node];
+			hierarchy.marks[node] |= DESCENDANT_CHANGED;
+			if (newlyMarked)
+				hierarchy.markedNodes.push_back(node);
+		}
+		if (newlyMarked)
+			hierarchy.dirtyRoots.push_back(node);
+	}
 
-		if (transform.parentID)
+	// Once many roots are dirty it is cheaper to collect them in order by stepping from root to root than to sort them
+	if (hierarchy.dirtyRoots.size() * TRANSFORM_SORT_RATIO < hierarchy.size())
+		std::sort(hierarchy.dirtyRoots.begin(), hierarchy.dirtyRoots.end());
+	else
+	{
+		hierarchy.dirtyRoots.clear();
+		for (unsigned int i = 0; i < hierarchy.size(); i = hierarchy.subtreeEnds[i])
 		{
-			const Transform2D& parentTransform = mTransform2DManager.getComponent(transform.parentID);
+			if (hierarchy.marks[i])
+				hierarchy.dirtyRoots.push_back(i);
+		}
+	}
 
-			transform.positionChanged |= parentTransform.positionChanged || parentTransform.rotationChanged || parentTransform.scaleChanged;
-			transform.rotationChanged |= parentTransform.rotationChanged;
-			transform.scaleChanged |= parentTransform.scaleChanged;
+	unsigned int root = 0;
+	for (TransformRange& range : hierarchy.ranges)
+	{
+		range.dirtyRootsBegin = root;
+		while (root < hierarchy.dirtyRoots.size() && hierarchy.dirtyRoots[root] < range.end)
+			root++;
+		range.dirtyRootsEnd = root;
+	}
+}
 
-			if (transform.positionChanged || transform.rotationChanged || transform.scaleChanged)
+/*
+Updates the world properties of every dynamic transform within a range which, or whose ancestors, changed since the last update. Only the hierarchies of the range's
+dirty roots are visited, descending into marked branches and the children of changed transforms. Ranges do not share any nodes or components so may be propagated
+concurrently.
+\param manager: Component manager of the transform type.
+\param hierarchy: Flattened hierarchy of the transform type.
+\param range: Range of the hierarchy to propagate, its changes are recorded in the range.
+\param rebuilt: Whether the hierarchy was flattened during this update, in which case transforms changed since the last update are assumed to have changed entirely.
+*/
+template <typename T, typename Hierarchy>
+void propagateRange(ComponentManager<T>& manager, Hierarchy& hierarchy, TransformRange& range, const bool& rebuilt)
+{
+	range.composedChildren.clear();
+	range.composedRoots.clear();
+	range.updated.clear();
+	range.changes.clear();
+
+	// Detect which transforms changed. Non dynamic transforms and their descendants are skipped, and once a transform becomes dynamic again its descendants are compared
+	// against their components, as they may have changed while being skipped
+	unsigned int refreshEnd = 0;
+	for (unsigned int root = range.dirtyRootsBegin; root < range.dirtyRootsEnd; root++)
+	{
+		unsigned int i = hierarchy.dirtyRoots[root];
+		unsigned int end = hierarchy.subtreeEnds[i];
+		while (i < end)
+		{
+			unsigned int parent = hierarchy.parents[i];
+			unsigned char parentFlags = parent != NO_PARENT ? hierarchy.flags[parent] : 0;
+
+			// Subtrees which neither changed nor contain a change are unaffected unless their parent changed
+			if (!hierarchy.marks[i] && !parentFlags && i >= refreshEnd)
+			{
+				i = hierarchy.subtreeEnds[i];
+				continue;
+			}
+
+			unsigned char flags = 0;
+
+			// Transforms which have not been accessed mutably since the last update are skipped without comparing their properties.
+			bool changed = hierarchy.marks[i] & TRANSFORM_CHANGED;
+			if (changed || i < refreshEnd)
 			{
-				transform.matrix = parentTransform.matrix * glm::translate(glm::mat4(1.0f), glm::vec3(transform.position, 0.0f)) * glm::rotate(glm::mat4(1.0f), glm::radians(transform.rotation), glm::vec3(0.0f, 0.0f, 1.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(transform.scale, 1.0f));
+				const T& transform = manager.readComponent(hierarchy.entityIDs[i]);
+				bool unfrozen = transform.dynamic && !hierarchy.dynamic[i]; // Ancestors may have moved while the subtree was baked, so it is recomputed entirely
+				if (unfrozen)
+					refreshEnd = std::max(refreshEnd, hierarchy.subtreeEnds[i]);
+				hierarchy.dynamic[i] = transform.dynamic;
 
-				if (transform.positionChanged)
+				if (transform.dynamic)
 				{
-					glm::vec4 temp = parentTransform.matrix * glm::vec4(transform.position, 0.0f, 1.0f);
-					transform.worldPosition = glm::vec2(temp.x, temp.y);
+					if ((changed && rebuilt) || unfrozen)
+						flags = POSITION_CHANGED | ROTATION_CHANGED | SCALE_CHANGED;
+					else
+						flags = changeFlags(transform.position != hierarchy.positions[i], transform.rotation != hierarchy.rotations[i], transform.scale != hierarchy.scales[i]);
+
+					if (flags)
+					{
+						hierarchy.positions[i] = transform.position;
+						hierarchy.rotations[i] = transform.rotation;
+						hierarchy.scales[i] = transform.scale;
+						(hierarchy.parents[i] != NO_PARENT ? range.composedChildren : range.composedRoots).push_back(i);
+					}
 				}
-				if (transform.rotationChanged)
-					transform.worldRotation = parentTransform.worldRotation + transform.rotation;
+			}
+
+			if (!hierarchy.dynamic[i])
+			{
+				i = hierarchy.subtreeEnds[i];
+				continue;
+			}
 
-				if (transform.scaleChanged)
-					transform.worldScale = parentTransform.worldScale * transform.scale;
+			// World position is also changed if it's parents position, rotation, or scale has changed.
+			if (parentFlags)
+				flags |= POSITION_CHANGED;
 
-				for (unsigned int i = 0; i < transform.changedCallbacks.length; i++)
-					(*transform.changedCallbacks[i])(transform);
+			// World rotation and scale are also changed if it's parents rotation and scale have changed respectively.
+			flags |= parentFlags & (ROTATION_CHANGED | SCALE_CHANGED);
 
-				transform.lastPosition = transform.position;
-				transform.lastRotation = transform.rotation;
-				transform.lastScale = transform.scale;
-			}
+			hierarchy.flags[i] = flags;
+			if (flags)
+				range.updated.push_back(i);
+			i++;
+		}
+	}
+
+	// A root's world matrix is its local matrix, so is composed in place
+	composeMatrices(hierarchy, range.composedChildren, hierarchy.localMatrices.data(), hierarchy.localNormalMatrices.data());
+	composeMatrices(hierarchy, range.composedRoots, hierarchy.worldMatrices.data(), hierarchy.worldNormalMatrices.data());
+
+	// Parents precede their children so each parent's world properties are up to date once its children are reached
+	for (const unsigned int& node : range.updated)
+	{
+		unsigned int parent = hierarchy.parents[node];
+		if (parent != NO_PARENT)
+		{
+			hierarchy.worldMatrices[node] = multiplyAffine(hierarchy.worldMatrices[parent], hierarchy.localMatrices[node]);
+			if constexpr (std::is_same<T, Transform>::value)
+				hierarchy.worldNormalMatrices[node] = hierarchy.worldNormalMatrices[parent] * hierarchy.localNormalMatrices[node]; // The inverse transpose of a product is the product of inverse transposes
+			hierarchy.worldRotations[node] = combineRotations(hierarchy.worldRotations[parent], hierarchy.rotations[node]);
+			hierarchy.worldScales[node] = hierarchy.worldScales[parent] * hierarchy.scales[node];
 		}
 		else
 		{
-			if (transform.positionChanged || transform.rotationChanged || transform.scaleChanged)
-			{
-				transform.matrix = glm::translate(glm::mat4(1.0f), glm::vec3(transform.position, 0.0f)) * glm::rotate(glm::mat4(1.0f), glm::radians(transform.rotation), glm::vec3(0.0f, 0.0f, 1.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(transform.scale, 1.0f));
+			hierarchy.worldRotations[node] = hierarchy.rotations[node];
+			hierarchy.worldScales[node] = hierarchy.scales[node];
+		}
 
-				transform.worldPosition = transform.position;
-				transform.worldRotation = transform.rotation;
-				transform.worldScale = transform.scale;
+		T& transform = manager.getComponent(hierarchy.entityIDs[node]);
+		transform.matrix = hierarchy.worldMatrices[node];
+		if constexpr (std::is_same<T, Transform>::value)
+			transform.normalMatrix = hierarchy.worldNormalMatrices[node];
+		transform.worldPosition = parent != NO_PARENT ? decltype(transform.worldPosition)(transform.matrix[3]) : hierarchy.positions[node];
+		transform.worldRotation = hierarchy.worldRotations[node];
+		transform.worldScale = hierarchy.worldScales[node];
 
-				for (unsigned int i = 0; i < transform.changedCallbacks.length; i++)
-					(*transform.changedCallbacks[i])(transform);
+		// Record change.
+		range.changes.push_back({ hierarchy.entityIDs[node], hierarchy.flags[node] });
+	}
+}
 
-				transform.lastPosition = transform.position;
-				transform.lastRotation = transform.rotation;
-				transform.lastScale = transform.scale;
-			}
-		}
+/*
+Updates the world properties of every dynamic transform which, or whose ancestors, changed since a tick, rebuilding the flattened hierarchy first if necessary.
+Independent root hierarchies are propagated in parallel, producing the same result regardless of the number of threads.
+\param manager: Component manager of the transform type.
+\param rootIDs: IDs of the entities whose transforms have no parent.
+\param hierarchy: Flattened hierarchy of the transform type.
+\param lastTick: Tick at which the last update ended.
+\param changes: Array the changed transforms are appended to.
+*/
+template <typename T, typename Hierarchy>
+void propagateTransforms(ComponentManager<T>& manager, const EntitySet& rootIDs, Hierarchy& hierarchy, const ChangeTick& lastTick, std::vector<TransformChange>& changes)
+{
+	static JobSystem& jobSystem = JobSystem::instance();
 
-		// Update children.
-		for (unsigned int i = 0; i < transform.childrenIDs.length; i++)
-			updateTransform2D(transform.childrenIDs[i]);
-	}
+	// Flattening copies the current properties so transforms changed since the last update cannot be compared against them, and are assumed to have changed entirely
+	bool rebuilt = hierarchy.dirty;
+	if (rebuilt)
+		flattenHierarchy(manager, rootIDs, hierarchy);
+	markChanges(manager, hierarchy, lastTick);
+
+	unsigned int nDirtyRanges = 0;
+	for (const TransformRange& range : hierarchy.ranges)
+		nDirtyRanges += range.dirtyRootsBegin != range.dirtyRootsEnd;
+
+	RangeJob propagateRanges = [&](const unsigned int& begin, const unsigned int& end)
+	{
+		for (unsigned int i = begin; i < end; i++)
+			propagateRange(manager, hierarchy, hierarchy.ranges[i], rebuilt);
+	};
+	if (nDirtyRanges > 1)
+		jobSystem.parallelFor(0, hierarchy.ranges.size(), 1, propagateRanges);
+	else
+		propagateRanges(0, hierarchy.ranges.size());
+
+	for (const TransformRange& range : hierarchy.ranges)
+		changes.insert(changes.end(), range.changes.begin(), range.changes.end());
+
+	for (const unsigned int& node : hierarchy.markedNodes)
+		hierarchy.marks[node] = 0;
+	hierarchy.markedNodes.clear();
 }
 
 TransformSystem& TransformSystem::instance()
@@ -408,12 +675,11 @@ TransformSystem::~TransformSystem()
 void TransformSystem::componentAdded(const Entity& entity)
 {
 	Transform& transform = entity.getComponent<Transform>();
-	transform.childrenIDs.initialize();
-	transform.changedCallbacks.initialize();
 	transform.entityID = entity.ID();
-	transform.parentID = NULL;
+	resetLinks(transform);
 
-	mEntityIDs.push_back(entity.ID());
+	mEntityIDs.insert(entity.ID());
+	mHierarchy.dirty = true;
 }
 
 void TransformSystem::componentRemoved(const Entity& entity)
@@ -422,26 +688,30 @@ void TransformSystem::componentRemoved(const Entity& entity)
 	if (transform.parentID)
 		mTransformManager.getComponent(transform.parentID).removeChild(entity);
 
-	for (unsigned int i = 0; i < transform.childrenIDs.length; i++)
+	// Children become roots
+	EntityID childID = transform.firstChildID;
+	while (childID)
 	{
-		mTransformManager.getComponent(transform.childrenIDs[i]).parentID = NULL;
-		mEntityIDs.push_back(transform.childrenIDs[i]);
+		Transform& child = mTransformManager.getComponent(childID);
+		childID = child.nextSiblingID;
+		child.parentID = NULL;
+		child.previousSiblingID = NULL;
+		child.nextSiblingID = NULL;
+		mEntityIDs.insert(child.entityID);
 	}
-	transform.childrenIDs.free();
-	transform.changedCallbacks.free();
 
-	mEntityIDs.erase(std::find(mEntityIDs.begin(), mEntityIDs.end(), entity.ID()));
+	mEntityIDs.erase(entity.ID());
+	mHierarchy.dirty = true;
 }
 
 void TransformSystem::component2DAdded(const Entity& entity)
 {
 	Transform2D& transform = entity.getComponent<Transform2D>();
-	transform.childrenIDs.initialize();
-	transform.changedCallbacks.initialize();
 	transform.entityID = entity.ID();
-	transform.parentID = NULL;
+	resetLinks(transform);
 
-	mEntity2DIDs.push_back(entity.ID());
+	mEntity2DIDs.insert(entity.ID());
+	mHierarchy2D.dirty = true;
 }
 
 void TransformSystem::component2DRemoved(const Entity& entity)
@@ -450,22 +720,51 @@ void TransformSystem::component2DRemoved(const Entity& entity)
 	if (transform.parentID)
 		mTransform2DManager.getComponent(transform.parentID).removeChild(entity);
 
-	for (unsigned int i = 0; i < transform.childrenIDs.length; i++)
+	EntityID childID = transform.firstChildID;
+	while (childID)
 	{
-		mTransform2DManager.getComponent(transform.childrenIDs[i]).parentID = NULL;
-		mEntity2DIDs.push_back(transform.childrenIDs[i]);
+		Transform2D& child = mTransform2DManager.getComponent(childID);
+		childID = child.nextSiblingID;
+		child.parentID = NULL;
+		child.previousSiblingID = NULL;
+		child.nextSiblingID = NULL;
+		mEntity2DIDs.insert(child.entityID);
 	}
-	transform.childrenIDs.free();
-	transform.changedCallbacks.free();
 
-	mEntity2DIDs.erase(std::find(mEntity2DIDs.begin(), mEntity2DIDs.end(), entity.ID()));
+	mEntity2DIDs.erase(entity.ID());
+	mHierarchy2D.dirty = true;
+}
+
+void TransformSystem::updateTransforms()
+{
+	mChanges.clear();
+	propagateTransforms(mTransformManager, mEntityIDs, mHierarchy, mLastTick, mChanges);
+	sortChanges(mChanges);
+
+	mLastTick = ComponentManagerBase::advanceTick(); // Writes made during the update are ignored next time
+}
+
+void TransformSystem::updateTransforms2D()
+{
+	mChanges2D.clear();
+	propagateTransforms(mTransform2DManager, mEntity2DIDs, mHierarchy2D, mLastTick2D, mChanges2D);
+	sortChanges(mChanges2D);
+
+	mLastTick2D = ComponentManagerBase::advanceTick();
+}
+
+void TransformSystem::update()
+{
+	updateTransforms();
+	updateTransforms2D();
 }
 
-void TransformSystem::update() const
+const std::vector<TransformChange>& TransformSystem::changes() const
 {
-	for (const EntityID& ID : mEntityIDs)
-		updateTransform(ID);
+	return mChanges;
+}
 
-	for (const EntityID& ID : mEntity2DIDs)
-		updateTransform2D(ID);
+const std::vector<TransformChange>& TransformSystem::changes2D() const
+{
+	return mChanges2D;
 }
@@ -1,8 +1,9 @@
 #pragma once
 #include "ComponentManager.h"
 #include "Vector.h"
-#include "glm/glm.hpp"
-#include "glm/gtc/quaternion.hpp"
+#include "EntitySet.h"
+#include "TransformMath.h"
+#include <type_traits>
 
 void print(const glm::vec2& vec2);
 void print(const glm::vec3& vec3);
@@ -10,28 +11,167 @@ void print(const glm::quat& quat);
 void print(const glm::mat3& matrix);
 void print(const glm::mat4& matrix);
 
-struct Transform;
-typedef std::function<void(Transform&)> TransformChangedCallback;
+// Bits describing which properties of a transform changed during a frame.
+enum TransformChangeFlags : unsigned char { POSITION_CHANGED = 1, ROTATION_CHANGED = 2, SCALE_CHANGED = 4 };
 
-struct Transform
-{   
-	/* Stores the IDs of the transform's children.
-	   IDs should NOT be directly appended and removed from the array but one should use the addChild and removeChild methods. */
-	Vector<EntityID> childrenIDs; 
+// Entry of the list of transforms which changed during a frame.
+struct TransformChange
+{
+	EntityID entityID;
+	unsigned char flags; // Combination of TransformChangeFlags
+};
+
+#define NO_PARENT UINT_MAX // Parent index of nodes at the root of a TransformHierarchy
+#define TRANSFORM_JOB_SIZE 4096 // Minimum number of transforms propagated by each job. Root hierarchies are never split between jobs
+#define TRANSFORM_SORT_RATIO 16 // Dirty roots are sorted while fewer than 1 in TRANSFORM_SORT_RATIO transforms are dirty roots, otherwise every root is checked in order
+
+// Contiguous range of a TransformHierarchy made of whole root hierarchies, which are independent of each other so each range is propagated by its own job.
+struct TransformRange
+{
+	unsigned int begin;
+	unsigned int end;
+
+	// Nodes whose local matrix changes during the current update, split by whether it is composed into their local or world matrix
+	std::vector<unsigned int> composedChildren;
+	std::vector<unsigned int> composedRoots;
+	std::vector<unsigned int> updated; // Nodes whose world properties change during the current update, in hierarchy order
+
+	std::vector<TransformChange> changes; // Changes recorded by the range's job, merged in range order once all jobs have completed
+
+	// Span of the hierarchy's dirty roots which lie within the range during the current update
+	unsigned int dirtyRootsBegin;
+	unsigned int dirtyRootsEnd;
+};
+
+// Bits marking which nodes of a TransformHierarchy must be visited during an update.
+enum TransformMarkFlags : unsigned char { TRANSFORM_CHANGED = 1, DESCENDANT_CHANGED = 2 };
+
+/*
+Transforms of one dimension flattened by TransformSystem into parallel arrays. Nodes are ordered depth first so every parent precedes its children and each subtree
+occupies a contiguous range, letting world matrices propagate in a single pass in which each node reads the already updated world matrix of its parent.
+Local properties are copies of the components' as of the last update and are compared against the components to detect which properties changed.
+Changed transforms mark their ancestors, so propagation only descends into branches containing a change and unchanged or static subtrees are never visited.
+*/
+template <typename Position, typename Rotation, typename Scale>
+struct TransformHierarchy
+{
+	std::vector<EntityID> entityIDs;
+	std::vector<unsigned int> parents; // Index of each node's parent, or NO_PARENT
+	std::vector<unsigned int> subtreeEnds; // One past the index of each node's last descendant
+	std::vector<unsigned char> dynamic;
+
+	std::vector<Position> positions;
+	std::vector<Rotation> rotations;
+	std::vector<Scale> scales;
+	std::vector<Rotation> worldRotations;
+	std::vector<Scale> worldScales;
+	std::vector<glm::mat4> localMatrices; // Unused by roots, whose world matrix is their local matrix
+	std::vector<glm::mat4> worldMatrices;
+	std::vector<glm::mat3> localNormalMatrices; // 3D only, unused by roots like localMatrices
+	std::vector<glm::mat3> worldNormalMatrices; // 3D only
+
+	std::vector<unsigned char> flags; // TransformChangeFlags of each node during the current update
+	std::vector<unsigned char> marks; // TransformMarkFlags of each node during the current update, all 0 between updates
+	std::vector<unsigned int> nodes; // Node index of each entity slot's transform, indexed by slot
+
+	std::vector<EntityID> changedIDs; // Entities whose transform changed since the last update
+	std::vector<unsigned int> markedNodes; // Nodes marked during the current update, so their marks can be cleared
+	std::vector<unsigned int> dirtyRoots; // Roots of hierarchies containing a marked node during the current update, in hierarchy order
+
+	std::vector<TransformRange> ranges; // Partition of the nodes into ranges propagated in parallel
+
+	bool dirty = true; // Whether transforms were added, removed, or reparented since the arrays were built
+
+	unsigned int size() const
+	{
+		return entityIDs.size();
+	}
+
+	void resize(const unsigned int& size)
+	{
+		entityIDs.resize(size);
+		parents.resize(size);
+		subtreeEnds.resize(size);
+		dynamic.resize(size);
+		positions.resize(size);
+		rotations.resize(size);
+		scales.resize(size);
+		worldRotations.resize(size);
+		worldScales.resize(size);
+		localMatrices.resize(size);
+		worldMatrices.resize(size);
+		if constexpr (std::is_same<Rotation, glm::quat>::value)
+		{
+			localNormalMatrices.resize(size);
+			worldNormalMatrices.resize(size);
+		}
+		flags.resize(size);
+		marks.resize(size);
+	}
+};
+
+typedef TransformHierarchy<glm::vec3, glm::quat, glm::vec3> TransformHierarchy3D;
+typedef TransformHierarchy<glm::vec2, float, glm::vec2> TransformHierarchy2D;
+
+// Iterates the IDs of a transform's children by following their sibling links.
+template <typename T>
+class ChildIterator
+{
+private:
+	EntityID mID;
+
+public:
+	ChildIterator(const EntityID& ID) : mID(ID) {};
+
+	const EntityID& operator*() const
+	{
+		return mID;
+	}
+
+	ChildIterator& operator++()
+	{
+		mID = ComponentManager<T>::instance().readComponent(mID).nextSiblingID;
+		return *this;
+	}
+
+	bool operator!=(const ChildIterator& other) const
+	{
+		return mID != other.mID;
+	}
+};
+
+// Range over the IDs of a transform's children in the order they were added, iterated without allocating. Children must not be added or removed while iterating.
+template <typename T>
+struct ChildRange
+{
+	EntityID firstChildID;
+
+	ChildIterator<T> begin() const
+	{
+		return firstChildID;
+	}
 
-	/* Stores callbacks to invoke upon change.
-	   Callbacks should NOT be directly appended and removed from the array but one should use subscribeChangedEvent and unsubscribeChangedEvent methods. */
-	Vector<TransformChangedCallback*> changedCallbacks;
+	ChildIterator<T> end() const
+	{
+		return NULL;
+	}
+};
 
+struct Transform
+{   
 	EntityID entityID;
 	EntityID parentID;
 
-	glm::mat4 matrix; // Matrix representing a translation, rotation, and enlargment to transform the object from the origin with no rotation and identity scale to its final state in world space.
+	/* Intrusive links forming a doubly linked list of the transform's children, NULL where absent, so children are attached and detached in constant time.
+	   Links should NOT be modified directly but one should use the addChild and removeChild methods. */
+	EntityID firstChildID;
+	EntityID lastChildID;
+	EntityID previousSiblingID;
+	EntityID nextSiblingID;
+	unsigned int nChildren;
 
-	// Detect change by comparing with last frame.
-	glm::vec3 lastPosition;
-	glm::quat lastRotation;
-	glm::vec3 lastScale;
+	glm::mat4 matrix; // Matrix representing a translation, rotation, and enlargment to transform the object from the origin with no rotation and identity scale to its final state in world space.
+	glm::mat3 normalMatrix; // Inverse transpose of the rotation and enlargement of matrix, transforms normals to world space.
 
 	glm::vec3 position;
 	glm::quat rotation;
@@ -42,9 +182,6 @@ struct Transform
 	glm::vec3 worldScale;
 
 	bool dynamic;
-	bool positionChanged;
-	bool rotationChanged;
-	bool scaleChanged;
 
 	glm::vec3 direction(const glm::vec3& direction = glm::vec3(0.0f, 0.0f, -1.0f)) const;
 	glm::vec3 worldDirection(const glm::vec3& direction = glm::vec3(0.0f, 0.0f, -1.0f)) const;
@@ -53,11 +190,17 @@ struct Transform
 	void rotate(const float& angle, const glm::vec3& axis);
 	void enlarge(const glm::vec3& factor);
 
+	/*
+	Attaches a transform as the last child of this transform, detaching it from its current parent first if it has one.
+	\param child: Entity possessing the child transform.
+	*/
 	void addChild(const Entity& child);
 	void removeChild(const Entity& child);
 
-	void subscribeChangedEvent(const TransformChangedCallback* callback);
-	void unsubscribeChangedEvent(const TransformChangedCallback* callback);
+	/*
+	\return Range over the IDs of the transform's children.
+	*/
+	ChildRange<Transform> children() const;
 };
 
 struct TransformCreateInfo
@@ -70,6 +213,12 @@ struct TransformCreateInfo
 	operator Transform() const;
 };
 
+template <>
+struct Reflection<Transform>
+{
+	static constexpr FieldInfo fields[] = { REFLECT_FIELD(Transform, position), REFLECT_FIELD(Transform, rotation), REFLECT_FIELD(Transform, scale), REFLECT_FIELD(Transform, dynamic) };
+};
+
 glm::mat3 translateMatrix(const glm::vec2& translation);
 
 /*
@@ -80,23 +229,19 @@ glm::mat3 rotateMatrix(const float& angle);
 
 glm::mat3 enlargeMatrix(const glm::vec2 enlargement);
 
-struct Transform2D;
-typedef std::function<void(Transform2D&)> Transform2DChangedCallback;
-
 struct Transform2D
 {
-	Vector<EntityID> childrenIDs;
-
-	Vector<Transform2DChangedCallback*> changedCallbacks;
-
 	EntityID entityID;
 	EntityID parentID;
 
-	glm::mat4 matrix;
+	// Intrusive links to the transform's children and siblings, see Transform
+	EntityID firstChildID;
+	EntityID lastChildID;
+	EntityID previousSiblingID;
+	EntityID nextSiblingID;
+	unsigned int nChildren;
 
-	glm::vec2 lastPosition;
-	float lastRotation;
-	glm::vec2 lastScale;
+	glm::mat4 matrix;
 
 	glm::vec2 position;
 	float rotation;
@@ -106,9 +251,6 @@ struct Transform2D
 	float worldRotation;
 	glm::vec2 worldScale;
 
-	bool positionChanged;
-	bool rotationChanged;
-	bool scaleChanged;
 	bool dynamic;
 
 	void translate(const glm::vec2& translation);
@@ -118,8 +260,7 @@ struct Transform2D
 	void addChild(const Entity& child);
 	void removeChild(const Entity& child);
 
-	void subscribeChangedEvent(const Transform2DChangedCallback* callback);
-	void unsubscribeChangedEvent(const Transform2DChangedCallback* callback);
+	ChildRange<Transform2D> children() const;
 };
 
 struct Transform2DCreateInfo
@@ -132,6 +273,12 @@ struct Transform2DCreateInfo
 	operator Transform2D() const;
 };
 
+template <>
+struct Reflection<Transform2D>
+{
+	static constexpr FieldInfo fields[] = { REFLECT_FIELD(Transform2D, position), REFLECT_FIELD(Transform2D, rotation), REFLECT_FIELD(Transform2D, scale), REFLECT_FIELD(Transform2D, dynamic) };
+};
+
 template<>
 std::vector<char> serialize(const Transform& transform);
 
@@ -152,13 +299,22 @@ private:
 	const ComponentRemovedCallback mComponent2DRemovedCallback = std::bind(&TransformSystem::component2DRemoved, this, std::placeholders::_1);
 	
 	// All transforms that have no parent, but may have children.
-	std::vector<EntityID> mEntityIDs;
-	std::vector<EntityID> mEntity2DIDs;
+	EntitySet mEntityIDs;
+	EntitySet mEntity2DIDs;
 
-	TransformSystem();
+	// Transforms flattened for propagation, rebuilt whenever the shape of the hierarchy changes
+	TransformHierarchy3D mHierarchy;
+	TransformHierarchy2D mHierarchy2D;
+
+	// Transforms which changed during the last update, sorted by entity slot.
+	std::vector<TransformChange> mChanges;
+	std::vector<TransformChange> mChanges2D;
 
-	void updateTransform(const EntityID& entityID) const;
-	void updateTransform2D(const EntityID& entityID) const;
+	// Ticks at which the last updates ended. Only transforms changed since are updated.
+	ChangeTick mLastTick = 0;
+	ChangeTick mLastTick2D = 0;
+
+	TransformSystem();
 
 public:
 	static TransformSystem& instance();
@@ -172,5 +328,23 @@ public:
 	void component2DAdded(const Entity& entity);
 	void component2DRemoved(const Entity & entity);
 
-	void update() const;
+	// Updates all 3D transforms and records those which have changed.
+	void updateTransforms();
+
+	// Updates all 2D transforms and records those which have changed.
+	void updateTransforms2D();
+
+	void update();
+
+	/*
+	Get the 3D transforms which changed during the last update. Systems consuming the list must declare read access to Transform so they are scheduled after the update.
+	\return Changed transforms sorted by entity slot. Entities may have been destroyed since the update.
+	*/
+	const std::vector<TransformChange>& changes() const;
+
+	/*
+	Get the 2D transforms which changed during the last update. Systems consuming the list must declare read access to Transform2D so they are scheduled after the update.
+	\return Changed transforms sorted by entity slot. Entities may have been destroyed since the update.
+	*/
+	const std::vector<TransformChange>& changes2D() const;
 };
@@ -0,0 +1,130 @@
+#include "TransformMath.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+inline FloatBatch batchLoad(const float* values) { return _mm256_load_ps(values); }
+inline void batchStore(float* values, const FloatBatch& batch) { _mm256_store_ps(values, batch); }
+inline FloatBatch batchSet(const float& value) { return _mm256_set1_ps(value); }
+inline FloatBatch batchAdd(const FloatBatch& a, const FloatBatch& b) { return _mm256_add_ps(a, b); }
+inline FloatBatch batchSub(const FloatBatch& a, const FloatBatch& b) { return _mm256_sub_ps(a, b); }
+inline FloatBatch batchMul(const FloatBatch& a, const FloatBatch& b) { return _mm256_mul_ps(a, b); }
+inline FloatBatch batchDiv(const FloatBatch& a, const FloatBatch& b) { return _mm256_div_ps(a, b); }
+#elif BATCH_WIDTH == 4 && !defined(__ARM_NEON)
+inline FloatBatch batchLoad(const float* values) { return _mm_load_ps(values); }
+inline void batchStore(float* values, const FloatBatch& batch) { _mm_store_ps(values, batch); }
+inline FloatBatch batchSet(const float& value) { return _mm_set1_ps(value); }
+inline FloatBatch batchAdd(const FloatBatch& a, const FloatBatch& b) { return _mm_add_ps(a, b); }
+inline FloatBatch batchSub(const FloatBatch& a, const FloatBatch& b) { return _mm_sub_ps(a, b); }
+inline FloatBatch batchMul(const FloatBatch& a, const FloatBatch& b) { return _mm_mul_ps(a, b); }
+inline FloatBatch batchDiv(const FloatBatch& a, const FloatBatch& b) { return _mm_div_ps(a, b); }
+#elif defined(__ARM_NEON)
+inline FloatBatch batchLoad(const float* values) { return vld1q_f32(values); }
+inline void batchStore(float* values, const FloatBatch& batch) { vst1q_f32(values, batch); }
+inline FloatBatch batchSet(const float& value) { return vdupq_n_f32(value); }
+inline FloatBatch batchAdd(const FloatBatch& a, const FloatBatch& b) { return vaddq_f32(a, b); }
+inline FloatBatch batchSub(const FloatBatch& a, const FloatBatch& b) { return vsubq_f32(a, b); }
+inline FloatBatch batchMul(const FloatBatch& a, const FloatBatch& b) { return vmulq_f32(a, b); }
+inline FloatBatch batchDiv(const FloatBatch& a, const FloatBatch& b)
+{
+	#if defined(__aarch64__)
+	return vdivq_f32(a, b);
+	#else
+	// 32 bit NEON has no division, so refine the reciprocal estimate with two Newton-Raphson steps
+	float32x4_t reciprocal = vrecpeq_f32(b);
+	reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+	reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+	return vmulq_f32(a, reciprocal);
+	#endif
+}
+#else
+inline FloatBatch batchLoad(const float* values) { return *values; }
+inline void batchStore(float* values, const FloatBatch& batch) { *values = batch; }
+inline FloatBatch batchSet(const float& value) { return value; }
+inline FloatBatch batchAdd(const FloatBatch& a, const FloatBatch& b) { return a + b; }
+inline FloatBatch batchSub(const FloatBatch& a, const FloatBatch& b) { return a - b; }
+inline FloatBatch batchMul(const FloatBatch& a, const FloatBatch& b) { return a * b; }
+inline FloatBatch batchDiv(const FloatBatch& a, const FloatBatch& b) { return a / b; }
+#endif
+
+void composeTransforms(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, const unsigned int* indices, const unsigned int& count, glm::mat4* matrices, glm::mat3* normalMatrices)
+{
+	// Inputs and outputs are transposed through lane arrays, so each batch holds one property of BATCH_WIDTH transforms
+	alignas(32) float input[7][BATCH_WIDTH]; // Rotation x, y, z, w, and scale x, y, z
+	alignas(32) float output[18][BATCH_WIDTH]; // Columns of the rotation and scale, then columns of the normal matrix
+
+	const FloatBatch one = batchSet(1.0f);
+	for (unsigned int begin = 0; begin < count; begin += BATCH_WIDTH)
+	{
+		unsigned int width = std::min(count - begin, (unsigned int)BATCH_WIDTH);
+
+		// Lanes past the end of the last batch repeat its last transform
+		for (unsigned int lane = 0; lane < BATCH_WIDTH; lane++)
+		{
+			unsigned int index = indices[begin + std::min(lane, width - 1)];
+			input[0][lane] = rotations[index].x;
+			input[1][lane] = rotations[index].y;
+			input[2][lane] = rotations[index].z;
+			input[3][lane] = rotations[index].w;
+			input[4][lane] = scales[index].x;
+			input[5][lane] = scales[index].y;
+			input[6][lane] = scales[index].z;
+		}
+
+		FloatBatch x = batchLoad(input[0]);
+		FloatBatch y = batchLoad(input[1]);
+		FloatBatch z = batchLoad(input[2]);
+		FloatBatch w = batchLoad(input[3]);
+		FloatBatch scale[3] = { batchLoad(input[4]), batchLoad(input[5]), batchLoad(input[6]) };
+
+		// Same expansion as glm::mat3_cast
+		FloatBatch x2 = batchAdd(x, x);
+		FloatBatch y2 = batchAdd(y, y);
+		FloatBatch z2 = batchAdd(z, z);
+		FloatBatch xx = batchMul(x, x2);
+		FloatBatch yy = batchMul(y, y2);
+		FloatBatch zz = batchMul(z, z2);
+		FloatBatch xy = batchMul(x, y2);
+		FloatBatch xz = batchMul(x, z2);
+		FloatBatch yz = batchMul(y, z2);
+		FloatBatch wx = batchMul(w, x2);
+		FloatBatch wy = batchMul(w, y2);
+		FloatBatch wz = batchMul(w, z2);
+
+		FloatBatch rotation[3][3] = {
+			{ batchSub(one, batchAdd(yy, zz)), batchAdd(xy, wz), batchSub(xz, wy) },
+			{ batchSub(xy, wz), batchSub(one, batchAdd(xx, zz)), batchAdd(yz, wx) },
+			{ batchAdd(xz, wy), batchSub(yz, wx), batchSub(one, batchAdd(xx, yy)) } };
+
+		// Scaling multiplies each column by the scale along it, so the inverse transpose divides each column instead
+		for (unsigned int column = 0; column < 3; column++)
+		{
+			for (unsigned int row = 0; row < 3; row++)
+			{
+				batchStore(output[column * 3 + row], batchMul(rotation[column][row], scale[column]));
+				batchStore(output[9 + column * 3 + row], batchDiv(rotation[column][row], scale[column]));
+			}
+		}
+
+		for (unsigned int lane = 0; lane < width; lane++)
+		{
+			unsigned int index = indices[begin + lane];
+			glm::mat4& matrix = matrices[index];
+			glm::mat3& normalMatrix = normalMatrices[index];
+			for (unsigned int column = 0; column < 3; column++)
+			{
+				matrix[column] = glm::vec4(output[column * 3][lane], output[column * 3 + 1][lane], output[column * 3 + 2][lane], 0.0f);
+				normalMatrix[column] = glm::vec3(output[9 + column * 3][lane], output[9 + column * 3 + 1][lane], output[9 + column * 3 + 2][lane]);
+			}
+			matrix[3] = glm::vec4(positions[index], 1.0f);
+		}
+	}
+}
+
+glm::mat3 normalMatrix(const glm::quat& rotation, const glm::vec3& scale)
+{
+	glm::mat3 matrix = glm::mat3_cast(rotation);
+	matrix[0] /= scale.x;
+	matrix[1] /= scale.y;
+	matrix[2] /= scale.z;
+	return matrix;
+}
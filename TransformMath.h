@@ -0,0 +1,55 @@
+#pragma once
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+// Select the widest instruction set available to batched transform kernels
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BATCH_WIDTH 8
+typedef __m256 FloatBatch;
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BATCH_WIDTH 4
+typedef __m128 FloatBatch;
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BATCH_WIDTH 4
+typedef float32x4_t FloatBatch;
+#else
+#define BATCH_WIDTH 1
+typedef float FloatBatch;
+#endif
+
+/*
+Composes the matrices translate(position) * mat4_cast(rotation) * scale(scale) of several transforms, along with their normal matrices, BATCH_WIDTH transforms at a time.
+The normal matrix, the inverse transpose of the rotation and scale, is computed directly as the rotation matrix with each column divided by the scale along it.
+\param positions: Array of positions, indexed by the elements of indices.
+\param rotations: Array of unit quaternions, indexed by the elements of indices.
+\param scales: Array of non-zero scales, indexed by the elements of indices.
+\param indices: Array of indices of the transforms to compose.
+\param count: Number of elements in indices.
+\param matrices: Array the matrices are written to, indexed by the elements of indices.
+\param normalMatrices: Array the normal matrices are written to, indexed by the elements of indices.
+*/
+void composeTransforms(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, const unsigned int* indices, const unsigned int& count, glm::mat4* matrices, glm::mat3* normalMatrices);
+
+/*
+Multiplies two affine matrices, whose bottom rows are (0, 0, 0, 1), skipping the products with the bottom row of the right matrix.
+\return a * b.
+*/
+inline glm::mat4 multiplyAffine(const glm::mat4& a, const glm::mat4& b)
+{
+	glm::mat4 result;
+	result[0] = a[0] * b[0].x + a[1] * b[0].y + a[2] * b[0].z;
+	result[1] = a[0] * b[1].x + a[1] * b[1].y + a[2] * b[1].z;
+	result[2] = a[0] * b[2].x + a[1] * b[2].y + a[2] * b[2].z;
+	result[3] = a[0] * b[3].x + a[1] * b[3].y + a[2] * b[3].z + a[3];
+	return result;
+}
+
+/*
+\param rotation: Unit quaternion.
+\param scale: Non-zero scale.
+\return The inverse transpose of mat3_cast(rotation) * scale.
+*/
+glm::mat3 normalMatrix(const glm::quat& rotation, const glm::vec3& scale);
@@ -0,0 +1,96 @@
+#pragma once
+#include "ComponentManager.h"
+#include <tuple>
+#include <type_traits>
+
+/*
+Query over all entities possessing every component type in Ts. Iterates the dense entity array of the smallest component pool and tests each entity's
+composition, so entities are visited without building per-system ID arrays. With ARCHETYPE_STORAGE the chunks of each matching archetype are iterated instead.
+Component types which are only read should be const qualified e.g View<Mesh, const Transform>, otherwise every visited component is marked as changed.
+Inactive entities are skipped. Components must not be added to or removed from entities while a view is being iterated.
+*/
+template <typename... Ts>
+class View
+{
+private:
+	template <typename T>
+	using Manager = ComponentManager<typename std::remove_const<T>::type>;
+
+	std::tuple<Manager<Ts>&...> mManagers;
+
+	Composition mComposition; // Composition an entity must contain to be visited
+	ComponentID mInactiveID = ComponentManager<Inactive>::instance().ID; // Entities possessing the Inactive tag are not visited
+
+	/*
+	\return The dense entity array of the component manager containing the fewest components.
+	*/
+	const std::vector<EntityID>& smallestPool() const
+	{
+		const std::vector<EntityID>* entities = nullptr;
+		((entities = (!entities || std::get<Manager<Ts>&>(mManagers).size() < entities->size()) ? &std::get<Manager<Ts>&>(mManagers).entities() : entities), ...);
+		return *entities;
+	}
+
+	/*
+	Gets an entity's component, marking it as changed unless T is const qualified.
+	\param manager: Component manager of T.
+	\param entityID: ID of the entity possessing the component.
+	\return A reference to the component.
+	*/
+	template <typename T>
+	static T& access(Manager<T>& manager, const EntityID& entityID)
+	{
+		if constexpr (std::is_const<T>::value)
+			return manager.readComponent(entityID);
+		else
+			return manager.getComponent(entityID);
+	}
+
+	// Marks an entity's component as changed unless T is const qualified.
+	template <typename T>
+	static void markChanged(Manager<T>& manager, const EntityID& entityID)
+	{
+		if constexpr (!std::is_const<T>::value)
+			manager.markChanged(entityID);
+	}
+
+public:
+	View() : mManagers(Manager<Ts>::instance()...), mComposition((Manager<Ts>::instance().bit | ...)) {}
+
+	/*
+	Invokes a procedure for every entity in the view.
+	\param function: Procedure to invoke. Must follow template: void [procedure name](const EntityID& [ID name], Ts&... [component names]).
+	*/
+	template <typename Function>
+	void each(Function function) const
+	{
+		#if ARCHETYPE_STORAGE
+		// Stream through the chunks of every archetype storing all of the component types
+		for (const Archetype* archetype : ArchetypeStorage::instance().archetypes())
+		{
+			if (!archetype->composition.contains(mComposition) || archetype->composition.test(mInactiveID))
+				continue;
+
+			for (const Chunk& chunk : archetype->chunks)
+			{
+				const EntityID* entities = archetype->entities(chunk);
+				std::tuple<Ts*...> arrays((Ts*)archetype->componentArray(chunk, std::get<Manager<Ts>&>(mManagers).ID)...);
+				for (unsigned int row = 0; row < chunk.size; row++)
+				{
+					(markChanged<Ts>(std::get<Manager<Ts>&>(mManagers), entities[row]), ...);
+					function(entities[row], std::get<Ts*>(arrays)[row]...);
+				}
+			}
+		}
+		#else
+		const std::vector<EntityID>& entities = smallestPool();
+		for (unsigned int i = 0; i < entities.size(); i++)
+		{
+			const EntityID ID = entities[i];
+			const Composition& composition = Entity::getCompositionFromID(ID);
+			if ((sizeof...(Ts) == 1 || composition.contains(mComposition)) && !composition.test(mInactiveID))
+				function(ID, access<Ts>(std::get<Manager<Ts>&>(mManagers), ID)...);
+		}
+		#endif
+	}
+};
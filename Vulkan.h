@@ -7,6 +7,38 @@
 
 /*--== CONFIG ==--*/
 #define SCENE_MENU true
+
+/* Store components in 16 KB chunks grouped by entity composition rather than one array per component type. Speeds up iterating several component types
+   at once, but adding or removing any component invalidates references to all components of that entity. */
+#define ARCHETYPE_STORAGE false
+
+#define JOB_THREADS 0 // Number of threads executing jobs on startup including the main thread, 0 to use one per hardware thread. Changed at runtime with JobSystem::setThreadCount
+
+#define SCHEDULER_TRACE false // Print when each system ran, and on which thread, every frame
+
+#define COMPONENT_BENCHMARK false // Print the time taken to add, get, iterate, and remove components with the sparse set and with an unordered_map indexed pool on startup
+
+#define JOB_BENCHMARK false // Stress the job system with chains of dependent jobs and print the time taken by a parallel workload at every thread count on startup
+
+#define INSTANTIATION_BENCHMARK false // Print the time taken to instantiate copies of a model and check their meshes match the model's on startup
+
+#define SERIALIZATION_BENCHMARK false // Print the throughput of serializing components one at a time and as whole pools, and check pools deserialize to identical components, on startup
+
+#define TRANSFORM_BENCHMARK false // Print the time taken to propagate transforms through deep chains and wide, flat scenes on startup
+
+#define PHYSICS_BENCHMARK false // Print the time taken to simulate a step of thousands of dynamic bodies on each thread count on startup
+
+/* Store entity names and index entities by name. Disabled by default in release builds to save memory; every entity is then named after its slot and cannot
+   be found by name. Define before this header to override. */
+#ifndef ENTITY_NAMES
+#ifdef NDEBUG
+#define ENTITY_NAMES false
+#else
+#define ENTITY_NAMES true
+#endif
+#endif
+
+#define MAX_COMPONENTS 128 // Number of component types that can be registered. Must be a multiple of 128; wider compositions make composition tests slower
 /*--============--*/
 
 /*--== CONSTANTS ==--*/